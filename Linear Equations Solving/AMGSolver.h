@@ -0,0 +1,570 @@
+#ifndef AMGSOLVER_H_
+#define AMGSOLVER_H_
+
+#include "SparseMatrix.h"
+#include "SolveControl.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <omp.h>
+
+using namespace std;
+
+enum class AMGCycle { V, W };
+enum class AMGSmoother { Chebyshev, GaussSeidel };
+
+inline const char* amgCycleName(AMGCycle c) {
+    return c == AMGCycle::W ? "W" : "V";
+}
+
+inline const char* amgSmootherName(AMGSmoother s) {
+    return s == AMGSmoother::GaussSeidel ? "multicolor-gauss-seidel" : "chebyshev";
+}
+
+// Smoothed-aggregation algebraic multigrid for large sparse systems such as
+// discretized PDEs. setup() builds the hierarchy: strong connections
+// |a_ij| >= theta * sqrt(|a_ii a_jj|) are grouped into aggregates, the
+// piecewise-constant tentative prolongator is smoothed with one damped
+// Jacobi step, and each coarse operator is the Galerkin product R A P with
+// R = P^T. The strength test, prolongator smoothing, transposes and sparse
+// products run in parallel; only the greedy aggregation passes are serial.
+// The coarsest level is factored densely.
+//
+// Smoothing is either a Jacobi-preconditioned Chebyshev polynomial or
+// Gauss-Seidel over a multicoloring of the matrix graph (rows of one color
+// never touch each other, so each color is a parallel sweep; pre-smoothing
+// runs colors forward and post-smoothing backward). Both keep the cycle
+// symmetric, so it works standalone or as a preconditioner for CG.
+template <typename T>
+class AMGSolver
+{
+private:
+    static const int COARSE_SIZE = 400;
+    static const int MAX_DENSE = 4000;
+    static const int MAX_LEVELS = 25;
+    static const int CHEBYSHEV_DEGREE = 3;
+    static const int POWER_ITERATIONS = 15;
+
+    struct Level
+    {
+        SparseMatrix<T> A;
+        SparseMatrix<T> P;
+        SparseMatrix<T> R;
+        vector<T> invDiag;
+        double lambdaMax = 0;
+        vector<int> colorStart;
+        vector<int> colorRows;
+        vector<T> x, b, r, d;
+    };
+
+    vector<Level> levels;
+    vector<T> coarseLU;
+    vector<int> coarsePivots;
+    bool coarseDirect;
+
+    AMGCycle cycleType;
+    AMGSmoother smoother;
+    bool preconditioned;
+    double strengthThreshold;
+    double tolerance;
+    int maxIterations;
+
+    SolveControl* control;
+
+    int iterations;
+    double relativeResidual;
+    double setupSeconds;
+    double solveSeconds;
+
+    static double dot(const T* a, const T* b, int n) {
+        double sum = 0;
+#pragma omp parallel for schedule(static) reduction(+:sum)
+        for (int i = 0; i < n; i++) sum += (double)a[i] * (double)b[i];
+        return sum;
+    }
+
+    // Largest eigenvalue of D^-1 A by power iteration; it only has to be
+    // an upper bound up to the safety margin the callers add.
+    static double estimateLambdaMax(const SparseMatrix<T>& A, const vector<T>& invDiag) {
+        int n = A.getRows();
+        vector<T> v(n), w(n);
+        for (int i = 0; i < n; i++) v[i] = (T)(1 + (i * 7919 % 13) / 13.0);
+
+        double lambda = 0;
+        for (int it = 0; it < POWER_ITERATIONS; it++) {
+            A.multiply(v.data(), w.data());
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) w[i] *= invDiag[i];
+
+            double norm = sqrt(dot(w.data(), w.data(), n));
+            if (norm == 0) break;
+            lambda = norm / sqrt(dot(v.data(), v.data(), n));
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) v[i] = w[i] / (T)norm;
+        }
+        return lambda;
+    }
+
+    // Three greedy passes: roots whose whole strong neighbourhood is still
+    // free start aggregates, leftovers join the aggregate they are most
+    // strongly connected to, and whatever remains forms new aggregates with
+    // its free neighbours. Returns the number of aggregates.
+    int aggregate(const SparseMatrix<T>& A, const vector<T>& diag, vector<int>& agg) const {
+        int n = A.getRows();
+        const int* rs = A.getRowStart();
+        const int* cs = A.getColumns();
+        const T* vs = A.getValues();
+        double theta2 = strengthThreshold * strengthThreshold;
+
+        vector<char> strong(A.getNonZeros());
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            for (int k = rs[i]; k < rs[i + 1]; k++) {
+                int j = cs[k];
+                double a = (double)vs[k];
+                strong[k] = j != i && a * a >= theta2 * fabs((double)diag[i] * (double)diag[j]);
+            }
+        }
+
+        agg.assign(n, -1);
+        int count = 0;
+
+        for (int i = 0; i < n; i++) {
+            bool free = true, connected = false;
+            for (int k = rs[i]; k < rs[i + 1] && free; k++) {
+                if (!strong[k]) continue;
+                connected = true;
+                if (agg[cs[k]] >= 0) free = false;
+            }
+            if (!free || !connected || agg[i] >= 0) continue;
+
+            agg[i] = count;
+            for (int k = rs[i]; k < rs[i + 1]; k++) {
+                if (strong[k]) agg[cs[k]] = count;
+            }
+            count++;
+        }
+
+        vector<int> joined(agg);
+        for (int i = 0; i < n; i++) {
+            if (agg[i] >= 0) continue;
+            double best = 0;
+            for (int k = rs[i]; k < rs[i + 1]; k++) {
+                if (strong[k] && agg[cs[k]] >= 0 && fabs((double)vs[k]) > best) {
+                    best = fabs((double)vs[k]);
+                    joined[i] = agg[cs[k]];
+                }
+            }
+        }
+        agg.swap(joined);
+
+        for (int i = 0; i < n; i++) {
+            if (agg[i] >= 0) continue;
+            agg[i] = count;
+            for (int k = rs[i]; k < rs[i + 1]; k++) {
+                if (strong[k] && agg[cs[k]] < 0) agg[cs[k]] = count;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    // P = (I - omega D^-1 A) P_tent with omega = 4 / (3 lambdaMax).
+    static SparseMatrix<T> smoothedProlongator(const Level& L, const vector<int>& agg, int count) {
+        int n = L.A.getRows();
+        vector<int> size(count, 0);
+        for (int i = 0; i < n; i++) size[agg[i]]++;
+
+        vector<int> start(n + 1);
+        vector<int> cols(n);
+        vector<T> vals(n);
+        for (int i = 0; i <= n; i++) start[i] = i;
+        for (int i = 0; i < n; i++) {
+            cols[i] = agg[i];
+            vals[i] = (T)(1 / sqrt((double)size[agg[i]]));
+        }
+        SparseMatrix<T> tentative(n, count, move(start), move(cols), move(vals));
+
+        SparseMatrix<T> S = L.A.multiply(tentative);
+        const int* rs = S.getRowStart();
+        const int* cs = S.getColumns();
+        T* vs = S.getValues();
+        T omega = (T)(4.0 / (3.0 * L.lambdaMax));
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            T scale = -omega * L.invDiag[i];
+            for (int k = rs[i]; k < rs[i + 1]; k++) {
+                vs[k] *= scale;
+                if (cs[k] == agg[i]) vs[k] += tentative.getValues()[i];
+            }
+        }
+        return S;
+    }
+
+    // Greedy coloring of the symmetrized graph, then rows bucketed by color.
+    static void colorLevel(Level& L) {
+        int n = L.A.getRows();
+        SparseMatrix<T> At = L.A.transpose();
+        const SparseMatrix<T>* graphs[2] = { &L.A, &At };
+
+        vector<int> color(n, -1);
+        vector<int> mark(n + 1, -1);
+        int colors = 0;
+        for (int i = 0; i < n; i++) {
+            for (const SparseMatrix<T>* g : graphs) {
+                for (int k = g->getRowStart()[i]; k < g->getRowStart()[i + 1]; k++) {
+                    int c = color[g->getColumns()[k]];
+                    if (c >= 0) mark[c] = i;
+                }
+            }
+            int c = 0;
+            while (mark[c] == i) c++;
+            color[i] = c;
+            colors = max(colors, c + 1);
+        }
+
+        L.colorStart.assign(colors + 1, 0);
+        for (int i = 0; i < n; i++) L.colorStart[color[i] + 1]++;
+        for (int c = 0; c < colors; c++) L.colorStart[c + 1] += L.colorStart[c];
+        vector<int> next(L.colorStart.begin(), L.colorStart.end() - 1);
+        L.colorRows.resize(n);
+        for (int i = 0; i < n; i++) L.colorRows[next[color[i]]++] = i;
+    }
+
+    static void chebyshev(Level& L, const T* b, T* x) {
+        int n = L.A.getRows();
+        T* r = L.r.data();
+        T* d = L.d.data();
+        const T* invDiag = L.invDiag.data();
+
+        double upper = L.lambdaMax, lower = upper / 30;
+        double theta = (upper + lower) / 2, delta = (upper - lower) / 2;
+        double sigma = theta / delta, rho = 1 / sigma;
+
+        L.A.residual(b, x, r);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            d[i] = invDiag[i] * r[i] / (T)theta;
+            x[i] += d[i];
+        }
+
+        for (int k = 1; k < CHEBYSHEV_DEGREE; k++) {
+            L.A.residual(b, x, r);
+            double rhoNext = 1 / (2 * sigma - rho);
+            T keep = (T)(rhoNext * rho), step = (T)(2 * rhoNext / delta);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) {
+                d[i] = keep * d[i] + step * invDiag[i] * r[i];
+                x[i] += d[i];
+            }
+            rho = rhoNext;
+        }
+    }
+
+    static void gaussSeidel(Level& L, const T* b, T* x, bool forward) {
+        const int* rs = L.A.getRowStart();
+        const int* cs = L.A.getColumns();
+        const T* vs = L.A.getValues();
+        int colors = (int)L.colorStart.size() - 1;
+
+        for (int step = 0; step < colors; step++) {
+            int c = forward ? step : colors - 1 - step;
+#pragma omp parallel for schedule(static)
+            for (int p = L.colorStart[c]; p < L.colorStart[c + 1]; p++) {
+                int i = L.colorRows[p];
+                T sum = b[i];
+                for (int k = rs[i]; k < rs[i + 1]; k++) {
+                    if (cs[k] != i) sum -= vs[k] * x[cs[k]];
+                }
+                x[i] = sum * L.invDiag[i];
+            }
+        }
+    }
+
+    void smooth(Level& L, const T* b, T* x, bool pre) {
+        if (smoother == AMGSmoother::GaussSeidel) gaussSeidel(L, b, x, pre);
+        else chebyshev(L, b, x);
+    }
+
+    bool factorCoarse() {
+        Level& L = levels.back();
+        int n = L.A.getRows();
+        coarseDirect = false;
+        if (n > MAX_DENSE) return false;
+
+        coarseLU.assign((size_t)n * n, 0);
+        coarsePivots.resize(n);
+        for (int i = 0; i < n; i++) {
+            for (int k = L.A.getRowStart()[i]; k < L.A.getRowStart()[i + 1]; k++) {
+                coarseLU[(size_t)i * n + L.A.getColumns()[k]] = L.A.getValues()[k];
+            }
+        }
+
+        for (int k = 0; k < n; k++) {
+            int p = k;
+            for (int i = k + 1; i < n; i++) {
+                if (fabs((double)coarseLU[(size_t)i * n + k]) > fabs((double)coarseLU[(size_t)p * n + k])) p = i;
+            }
+            if (coarseLU[(size_t)p * n + k] == 0) return false;
+            coarsePivots[k] = p;
+            if (p != k) {
+                swap_ranges(coarseLU.begin() + (size_t)k * n, coarseLU.begin() + (size_t)(k + 1) * n,
+                    coarseLU.begin() + (size_t)p * n);
+            }
+
+            const T* pr = &coarseLU[(size_t)k * n];
+#pragma omp parallel for schedule(static) if (n - k > 256)
+            for (int i = k + 1; i < n; i++) {
+                T* r = &coarseLU[(size_t)i * n];
+                T l = r[k] / pr[k];
+                r[k] = l;
+                for (int j = k + 1; j < n; j++) r[j] -= l * pr[j];
+            }
+        }
+        coarseDirect = true;
+        return true;
+    }
+
+    // Without a usable factorization (too large or singular) the coarsest
+    // level is only smoothed, which still damps what the smoother can reach.
+    void coarseSolve(Level& L, const T* b, T* x) {
+        int n = L.A.getRows();
+        if (!coarseDirect) {
+            for (int s = 0; s < 10; s++) {
+                smooth(L, b, x, true);
+                smooth(L, b, x, false);
+            }
+            return;
+        }
+
+        for (int i = 0; i < n; i++) x[i] = b[i];
+        for (int k = 0; k < n; k++) {
+            if (coarsePivots[k] != k) std::swap(x[k], x[coarsePivots[k]]);
+        }
+        for (int i = 1; i < n; i++) {
+            const T* r = &coarseLU[(size_t)i * n];
+            T sum = x[i];
+            for (int j = 0; j < i; j++) sum -= r[j] * x[j];
+            x[i] = sum;
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            const T* r = &coarseLU[(size_t)i * n];
+            T sum = x[i];
+            for (int j = i + 1; j < n; j++) sum -= r[j] * x[j];
+            x[i] = sum / r[i];
+        }
+    }
+
+    void cycle(int l, const T* b, T* x) {
+        Level& L = levels[l];
+        if (l + 1 == (int)levels.size()) {
+            coarseSolve(L, b, x);
+            return;
+        }
+
+        smooth(L, b, x, true);
+        L.A.residual(b, x, L.r.data());
+
+        Level& C = levels[l + 1];
+        L.R.multiply(L.r.data(), C.b.data());
+        fill(C.x.begin(), C.x.end(), (T)0);
+
+        int visits = (cycleType == AMGCycle::W && l + 2 < (int)levels.size()) ? 2 : 1;
+        for (int v = 0; v < visits; v++) cycle(l + 1, C.b.data(), C.x.data());
+
+        const int* rs = L.P.getRowStart();
+        const int* cs = L.P.getColumns();
+        const T* vs = L.P.getValues();
+        const T* xc = C.x.data();
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < L.A.getRows(); i++) {
+            T sum = 0;
+            for (int k = rs[i]; k < rs[i + 1]; k++) sum += vs[k] * xc[cs[k]];
+            x[i] += sum;
+        }
+
+        smooth(L, b, x, false);
+    }
+
+public:
+    AMGSolver(AMGCycle cycle = AMGCycle::V, AMGSmoother smooth = AMGSmoother::Chebyshev, bool asPreconditioner = true)
+        : coarseDirect(false), cycleType(cycle), smoother(smooth), preconditioned(asPreconditioner),
+        strengthThreshold(0.08), tolerance(1e-8), maxIterations(500), control(nullptr),
+        iterations(0), relativeResidual(0), setupSeconds(0), solveSeconds(0) {
+    }
+
+    void setCycle(AMGCycle cycle) { cycleType = cycle; }
+    AMGCycle getCycle() const { return cycleType; }
+    void setSmoother(AMGSmoother smooth) { smoother = smooth; }
+    AMGSmoother getSmoother() const { return smoother; }
+    // true: one cycle preconditions conjugate gradients; false: plain
+    // multigrid iteration, one cycle per step.
+    void setPreconditioner(bool enabled) { preconditioned = enabled; }
+    bool isPreconditioner() const { return preconditioned; }
+    void setTolerance(double tol) { tolerance = tol; }
+    void setMaxIterations(int iters) { maxIterations = iters; }
+    void setStrengthThreshold(double theta) { strengthThreshold = theta; }
+    // Checked once per iteration of solve(); see LinearSystem::setSolveControl.
+    void setSolveControl(SolveControl* solveControl) { control = solveControl; }
+
+    // Builds the hierarchy for A. Fails when A is not square or a row has
+    // no diagonal entry.
+    bool setup(const SparseMatrix<T>& A) {
+        auto start = chrono::high_resolution_clock::now();
+        levels.clear();
+        coarseDirect = false;
+        setupSeconds = 0;
+        if (A.getRows() != A.getCols() || A.getRows() == 0) return false;
+
+        levels.emplace_back();
+        levels[0].A = A;
+
+        while (true) {
+            Level& L = levels.back();
+            int n = L.A.getRows();
+            vector<T> diag = L.A.diagonal();
+
+            bool usable = true;
+            for (int i = 0; i < n && usable; i++) usable = diag[i] != 0;
+            if (!usable) {
+                if (levels.size() == 1) return false;
+                levels.pop_back();
+                levels.back().P = SparseMatrix<T>();
+                levels.back().R = SparseMatrix<T>();
+                break;
+            }
+
+            L.invDiag.resize(n);
+            for (int i = 0; i < n; i++) L.invDiag[i] = 1 / diag[i];
+            L.lambdaMax = 1.1 * estimateLambdaMax(L.A, L.invDiag);
+            if (n <= COARSE_SIZE || (int)levels.size() == MAX_LEVELS) break;
+
+            vector<int> agg;
+            int count = aggregate(L.A, diag, agg);
+            if (count == 0 || count >= n) break;
+
+            L.P = smoothedProlongator(L, agg, count);
+            L.R = L.P.transpose();
+            SparseMatrix<T> coarse = L.R.multiply(L.A.multiply(L.P));
+
+            levels.emplace_back();
+            levels.back().A = move(coarse);
+        }
+
+        for (Level& L : levels) {
+            int n = L.A.getRows();
+            L.x.assign(n, 0);
+            L.b.assign(n, 0);
+            L.r.assign(n, 0);
+            L.d.assign(n, 0);
+            if (smoother == AMGSmoother::GaussSeidel) colorLevel(L);
+        }
+        factorCoarse();
+
+        auto end = chrono::high_resolution_clock::now();
+        setupSeconds = chrono::duration<double>(end - start).count();
+        return true;
+    }
+
+    // Solves A x = b for the A given to setup(), starting from x. Returns
+    // true when the residual drops below tolerance * |b|.
+    bool solve(const T* b, T* x) {
+        auto start = chrono::high_resolution_clock::now();
+        iterations = 0;
+        relativeResidual = 0;
+        if (levels.empty()) return false;
+
+        const SparseMatrix<T>& A = levels[0].A;
+        int n = A.getRows();
+        double bNorm = sqrt(dot(b, b, n));
+        if (bNorm == 0) {
+            for (int i = 0; i < n; i++) x[i] = 0;
+            solveSeconds = 0;
+            return true;
+        }
+
+        vector<T> r(n);
+        A.residual(b, x, r.data());
+        relativeResidual = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+
+        if (!preconditioned) {
+            while (relativeResidual > tolerance && iterations < maxIterations) {
+                if (control && control->checkpoint("iteration", iterations, maxIterations, relativeResidual)) break;
+                cycle(0, b, x);
+                A.residual(b, x, r.data());
+                relativeResidual = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+                iterations++;
+                if (!std::isfinite(relativeResidual)) break;
+            }
+        }
+        else {
+            vector<T> z(n, 0), p(n), q(n);
+            cycle(0, r.data(), z.data());
+            p = z;
+            double rz = dot(r.data(), z.data(), n);
+
+            while (relativeResidual > tolerance && iterations < maxIterations) {
+                if (control && control->checkpoint("iteration", iterations, maxIterations, relativeResidual)) break;
+                A.multiply(p.data(), q.data());
+                double pq = dot(p.data(), q.data(), n);
+                if (pq == 0 || !std::isfinite(pq)) break;
+                T alpha = (T)(rz / pq);
+
+#pragma omp parallel for schedule(static)
+                for (int i = 0; i < n; i++) {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                }
+                relativeResidual = sqrt(dot(r.data(), r.data(), n)) / bNorm;
+                iterations++;
+                if (relativeResidual <= tolerance || !std::isfinite(relativeResidual)) break;
+
+                fill(z.begin(), z.end(), (T)0);
+                cycle(0, r.data(), z.data());
+                double rzNext = dot(r.data(), z.data(), n);
+                T beta = (T)(rzNext / rz);
+                rz = rzNext;
+#pragma omp parallel for schedule(static)
+                for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+            }
+        }
+
+        auto end = chrono::high_resolution_clock::now();
+        solveSeconds = chrono::duration<double>(end - start).count();
+        return relativeResidual <= tolerance;
+    }
+
+    int getLevelCount() const { return (int)levels.size(); }
+    int getIterations() const { return iterations; }
+    double getRelativeResidual() const { return relativeResidual; }
+    double getSetupSeconds() const { return setupSeconds; }
+    double getSolveSeconds() const { return solveSeconds; }
+
+    // Nonzeros over all levels divided by those of A; the memory and
+    // per-cycle work of the hierarchy relative to one product with A.
+    double getOperatorComplexity() const {
+        if (levels.empty()) return 0;
+        double total = 0;
+        for (const Level& L : levels) total += (double)L.A.getNonZeros();
+        return total / (double)levels[0].A.getNonZeros();
+    }
+
+    void printHierarchy() const {
+        cout << left << setw(8) << "level" << setw(14) << "rows" << setw(16) << "nonzeros" << "colors" << endl;
+        for (size_t l = 0; l < levels.size(); l++) {
+            const Level& L = levels[l];
+            cout << left << setw(8) << l << setw(14) << L.A.getRows() << setw(16) << L.A.getNonZeros();
+            if (L.colorStart.empty()) cout << "-";
+            else cout << L.colorStart.size() - 1;
+            cout << endl;
+        }
+        cout << "Operator complexity: " << getOperatorComplexity()
+            << (coarseDirect ? ", coarsest level solved directly" : ", coarsest level smoothed") << endl;
+    }
+};
+
+#endif
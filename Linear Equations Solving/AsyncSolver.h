@@ -0,0 +1,50 @@
+#ifndef ASYNCSOLVER_H_
+#define ASYNCSOLVER_H_
+
+#include "LinearSystem.h"
+#include "SolverBackend.h"
+#include "SolveControl.h"
+#include <future>
+#include <memory>
+#include <functional>
+
+using namespace std;
+
+// Non-blocking front end for every solve path. Each call runs the work on
+// its own thread and returns a future for the outcome; the SolveControl is
+// attached to the system for exactly that long, so cancel(), a deadline and
+// the progress callback reach the solver's checkpoints. When the future is
+// ready the worker's OpenMP team has already been released. The system must
+// not be touched by anyone else until then.
+template <typename T>
+class AsyncSolver
+{
+public:
+    static future<SolveStatus> start(LinearSystem<T>* sys, shared_ptr<SolveControl> control,
+        function<bool(LinearSystem<T>*)> work) {
+        return async(launch::async, [sys, control, work]() {
+            sys->setSolveControl(control.get());
+            bool ok = work(sys);
+            sys->setSolveControl(nullptr);
+
+            if (ok) return SolveStatus::Solved;
+            if (control->isStopped()) return control->stopStatus();
+            return SolveStatus::NoUniqueSolution;
+        });
+    }
+
+    static future<SolveStatus> solve(LinearSystem<T>* sys, shared_ptr<SolveControl> control) {
+        return start(sys, control, [](LinearSystem<T>* s) { return s->solve(); });
+    }
+
+    static future<SolveStatus> solveAll(LinearSystem<T>* sys, shared_ptr<SolveControl> control) {
+        return start(sys, control, [](LinearSystem<T>* s) { return s->solveAll(); });
+    }
+
+    static future<SolveStatus> run(shared_ptr<SolverBackend<T>> backend, LinearSystem<T>* sys,
+        const TuningParams& params, shared_ptr<SolveControl> control) {
+        return start(sys, control, [backend, params](LinearSystem<T>* s) { return backend->run(s, params); });
+    }
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef BACKENDCOMPARISON_H_
+#define BACKENDCOMPARISON_H_
+
+#include "SolverBackend.h"
+#include "SolverAutotuner.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <omp.h>
+
+using namespace std;
+
+struct ComparisonResult {
+    int n;
+    string backend;
+    double seconds;
+    double gflops;
+    double growth;
+    double residual;
+    double backwardError;
+};
+
+// Times every registered backend that handles a dense random square system
+// on identical inputs for N = 64, 128, ... up to maxN, prints a table with
+// each backend's slowdown against the fastest one at that N, and writes the
+// same numbers as JSON. With LINEAR_SOLVER_USE_LAPACK this is the in-tree
+// versus vendor comparison. Backends that report a growth factor (partial
+// pivoting and CALU) get a second table, the accuracy side of the trade;
+// every solve is then verified against its original rows for a third.
+template <typename T>
+class BackendComparison
+{
+private:
+    vector<ComparisonResult> results;
+
+    static int availableThreads() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+public:
+    void run(int maxN) {
+        results.clear();
+        vector<shared_ptr<SolverBackend<T>>> backends = SolverRegistry<T>::all();
+        TuningParams params = { 64, 0, true };
+
+        cout << left << setw(8) << "N";
+        for (auto& b : backends) cout << setw(22) << b->getName();
+        cout << endl;
+
+        for (int n = 64; n <= maxN; n *= 2) {
+            SystemProfile profile = { n, n, 1.0, false };
+            vector<double> times;
+            double fastest = -1;
+
+            for (auto& b : backends) {
+                VerificationReport check = {};
+                double t = b->supports(profile) ? SolverAutotuner<T>::timeBackend(*b, params, n, n <= 256 ? 3 : 1, &check) : -1;
+                times.push_back(t);
+                if (t > 0 && (fastest < 0 || t < fastest)) fastest = t;
+
+                if (t > 0) {
+                    double flops = 2.0 / 3.0 * (double)n * n * n;
+                    results.push_back({ n, b->getName(), t, flops / t * 1e-9, b->getGrowthFactor(),
+                        check.residualMax, check.backwardError });
+                }
+            }
+
+            cout << left << setw(8) << n;
+            for (double t : times) {
+                ostringstream cell;
+                if (t > 0) cell << fixed << setprecision(4) << t << "s x" << setprecision(2) << (t / fastest);
+                else cell << "-";
+                cout << setw(22) << cell.str();
+            }
+            cout << endl;
+        }
+
+        cout << "\nGrowth factor max|U| / max|A| (same inputs):" << endl;
+        cout << left << setw(8) << "N";
+        for (auto& b : backends) cout << setw(22) << b->getName();
+        cout << endl;
+        for (int n = 64; n <= maxN; n *= 2) {
+            cout << left << setw(8) << n;
+            for (auto& b : backends) {
+                string cell = "-";
+                for (const ComparisonResult& r : results) {
+                    if (r.n == n && r.backend == b->getName() && r.growth > 0) {
+                        ostringstream g;
+                        g << setprecision(4) << r.growth;
+                        cell = g.str();
+                    }
+                }
+                cout << setw(22) << cell;
+            }
+            cout << endl;
+        }
+
+        cout << "\nBackward error ||Ax - b|| / (||A|| ||x|| + ||b||), compensated residual:" << endl;
+        cout << left << setw(8) << "N";
+        for (auto& b : backends) cout << setw(22) << b->getName();
+        cout << endl;
+        for (int n = 64; n <= maxN; n *= 2) {
+            cout << left << setw(8) << n;
+            for (auto& b : backends) {
+                string cell = "-";
+                for (const ComparisonResult& r : results) {
+                    if (r.n == n && r.backend == b->getName()) {
+                        ostringstream e;
+                        e << setprecision(3) << r.backwardError;
+                        cell = e.str();
+                    }
+                }
+                cout << setw(22) << cell;
+            }
+            cout << endl;
+        }
+    }
+
+    bool writeJson(const string& path) const {
+        ofstream out(path);
+        if (!out) return false;
+
+        out << "{\n  \"threads\": " << availableThreads() << ",\n";
+#ifdef LINEAR_SOLVER_USE_LAPACK
+        out << "  \"vendor_lapack\": true,\n";
+#else
+        out << "  \"vendor_lapack\": false,\n";
+#endif
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const ComparisonResult& r = results[i];
+            out << "    { \"n\": " << r.n << ", \"backend\": \"" << r.backend << "\", \"seconds\": "
+                << r.seconds << ", \"gflops\": " << r.gflops << ", \"growth\": " << r.growth
+                << ", \"residual\": " << r.residual << ", \"backward_error\": " << r.backwardError << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return true;
+    }
+
+    const vector<ComparisonResult>& getResults() const { return results; }
+};
+
+#endif
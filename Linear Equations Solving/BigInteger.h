@@ -0,0 +1,318 @@
+#ifndef BIGINTEGER_H_
+#define BIGINTEGER_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Minimal signed multi-precision integer for CRT and rational
+// reconstruction: magnitude in base 2^32 limbs, least significant first,
+// no leading zero limbs (zero is the empty vector).
+class BigInteger
+{
+private:
+    vector<uint32_t> mag;
+    bool negative;
+
+    void trim() {
+        while (!mag.empty() && mag.back() == 0) mag.pop_back();
+        if (mag.empty()) negative = false;
+    }
+
+    static int compareMag(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static vector<uint32_t> addMag(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        const vector<uint32_t>& big = a.size() >= b.size() ? a : b;
+        const vector<uint32_t>& small = a.size() >= b.size() ? b : a;
+        vector<uint32_t> out(big.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < big.size(); i++) {
+            uint64_t s = (uint64_t)big[i] + (i < small.size() ? small[i] : 0) + carry;
+            out[i] = (uint32_t)s;
+            carry = s >> 32;
+        }
+        out[big.size()] = (uint32_t)carry;
+        return out;
+    }
+
+    // Requires |a| >= |b|.
+    static vector<uint32_t> subMag(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> out(a.size());
+        int64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            int64_t d = (int64_t)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+            borrow = d < 0 ? 1 : 0;
+            out[i] = (uint32_t)d;
+        }
+        return out;
+    }
+
+    static vector<uint32_t> mulMag(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        if (a.empty() || b.empty()) return {};
+        vector<uint32_t> out(a.size() + b.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < b.size(); j++) {
+                uint64_t cur = (uint64_t)a[i] * b[j] + out[i + j] + carry;
+                out[i + j] = (uint32_t)cur;
+                carry = cur >> 32;
+            }
+            out[i + b.size()] = (uint32_t)carry;
+        }
+        return out;
+    }
+
+    // Knuth algorithm D on magnitudes.
+    static void divModMag(const vector<uint32_t>& u, const vector<uint32_t>& v,
+        vector<uint32_t>& q, vector<uint32_t>& r) {
+        if (compareMag(u, v) < 0) {
+            q.clear();
+            r = u;
+            return;
+        }
+
+        if (v.size() == 1) {
+            q.assign(u.size(), 0);
+            uint64_t rem = 0;
+            for (size_t i = u.size(); i-- > 0;) {
+                uint64_t cur = (rem << 32) | u[i];
+                q[i] = (uint32_t)(cur / v[0]);
+                rem = cur % v[0];
+            }
+            r.clear();
+            if (rem) r.push_back((uint32_t)rem);
+            while (!q.empty() && q.back() == 0) q.pop_back();
+            return;
+        }
+
+        int shift = 0;
+        for (uint32_t top = v.back(); !(top & 0x80000000u); top <<= 1) shift++;
+
+        size_t n = v.size(), m = u.size() - n;
+        vector<uint32_t> vn(n), un(u.size() + 1);
+        for (size_t i = n; i-- > 1;) {
+            vn[i] = (v[i] << shift) | (shift ? (uint32_t)((uint64_t)v[i - 1] >> (32 - shift)) : 0);
+        }
+        vn[0] = v[0] << shift;
+        un[u.size()] = shift ? (uint32_t)((uint64_t)u.back() >> (32 - shift)) : 0;
+        for (size_t i = u.size(); i-- > 1;) {
+            un[i] = (u[i] << shift) | (shift ? (uint32_t)((uint64_t)u[i - 1] >> (32 - shift)) : 0);
+        }
+        un[0] = u[0] << shift;
+
+        q.assign(m + 1, 0);
+        const uint64_t base = (uint64_t)1 << 32;
+
+        for (size_t j = m + 1; j-- > 0;) {
+            uint64_t num = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+            uint64_t qhat = num / vn[n - 1];
+            uint64_t rhat = num % vn[n - 1];
+
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if (rhat >= base) break;
+            }
+
+            int64_t borrow = 0;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t p = qhat * vn[i] + carry;
+                carry = p >> 32;
+                int64_t t = (int64_t)un[i + j] - (int64_t)(uint32_t)p - borrow;
+                un[i + j] = (uint32_t)t;
+                borrow = t < 0 ? 1 : 0;
+            }
+            int64_t t = (int64_t)un[j + n] - (int64_t)carry - borrow;
+            un[j + n] = (uint32_t)t;
+
+            if (t < 0) {
+                qhat--;
+                uint64_t c = 0;
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t s = (uint64_t)un[i + j] + vn[i] + c;
+                    un[i + j] = (uint32_t)s;
+                    c = s >> 32;
+                }
+                un[j + n] += (uint32_t)c;
+            }
+            q[j] = (uint32_t)qhat;
+        }
+
+        r.assign(n, 0);
+        for (size_t i = 0; i < n; i++) {
+            r[i] = (un[i] >> shift) | (shift ? (uint32_t)((uint64_t)un[i + 1] << (32 - shift)) : 0);
+        }
+        while (!q.empty() && q.back() == 0) q.pop_back();
+        while (!r.empty() && r.back() == 0) r.pop_back();
+    }
+
+public:
+    BigInteger() : negative(false) {}
+
+    BigInteger(long long value) : negative(value < 0) {
+        unsigned long long m = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+        while (m) {
+            mag.push_back((uint32_t)m);
+            m >>= 32;
+        }
+    }
+
+    bool isZero() const { return mag.empty(); }
+    bool isNegative() const { return negative; }
+    size_t bitLength() const {
+        if (mag.empty()) return 0;
+        size_t bits = (mag.size() - 1) * 32;
+        for (uint32_t top = mag.back(); top; top >>= 1) bits++;
+        return bits;
+    }
+
+    BigInteger abs() const {
+        BigInteger r = *this;
+        r.negative = false;
+        return r;
+    }
+
+    BigInteger operator-() const {
+        BigInteger r = *this;
+        if (!r.isZero()) r.negative = !r.negative;
+        return r;
+    }
+
+    friend BigInteger operator+(const BigInteger& a, const BigInteger& b) {
+        BigInteger r;
+        if (a.negative == b.negative) {
+            r.mag = addMag(a.mag, b.mag);
+            r.negative = a.negative;
+        }
+        else if (compareMag(a.mag, b.mag) >= 0) {
+            r.mag = subMag(a.mag, b.mag);
+            r.negative = a.negative;
+        }
+        else {
+            r.mag = subMag(b.mag, a.mag);
+            r.negative = b.negative;
+        }
+        r.trim();
+        return r;
+    }
+
+    friend BigInteger operator-(const BigInteger& a, const BigInteger& b) { return a + (-b); }
+
+    friend BigInteger operator*(const BigInteger& a, const BigInteger& b) {
+        BigInteger r;
+        r.mag = mulMag(a.mag, b.mag);
+        r.negative = a.negative != b.negative;
+        r.trim();
+        return r;
+    }
+
+    // Truncating division, like the built-in integer types.
+    static void divMod(const BigInteger& a, const BigInteger& b, BigInteger& q, BigInteger& r) {
+        divModMag(a.mag, b.mag, q.mag, r.mag);
+        q.negative = a.negative != b.negative;
+        r.negative = a.negative;
+        q.trim();
+        r.trim();
+    }
+
+    friend bool operator<(const BigInteger& a, const BigInteger& b) {
+        if (a.negative != b.negative) return a.negative;
+        int c = compareMag(a.mag, b.mag);
+        return a.negative ? c > 0 : c < 0;
+    }
+    friend bool operator>(const BigInteger& a, const BigInteger& b) { return b < a; }
+    friend bool operator<=(const BigInteger& a, const BigInteger& b) { return !(b < a); }
+    friend bool operator==(const BigInteger& a, const BigInteger& b) {
+        return a.negative == b.negative && a.mag == b.mag;
+    }
+    friend bool operator!=(const BigInteger& a, const BigInteger& b) { return !(a == b); }
+
+    // Non-negative remainder of the value modulo a word-size m.
+    uint32_t mod(uint32_t m) const {
+        uint64_t rem = 0;
+        for (size_t i = mag.size(); i-- > 0;) rem = ((rem << 32) | mag[i]) % m;
+        if (negative && rem) rem = m - rem;
+        return (uint32_t)rem;
+    }
+
+    void mulAddSmall(uint32_t factor, uint32_t addend) {
+        uint64_t carry = addend;
+        for (size_t i = 0; i < mag.size(); i++) {
+            uint64_t cur = (uint64_t)mag[i] * factor + carry;
+            mag[i] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+        if (carry) mag.push_back((uint32_t)carry);
+        trim();
+    }
+
+    static BigInteger gcd(BigInteger a, BigInteger b) {
+        a = a.abs();
+        b = b.abs();
+        while (!b.isZero()) {
+            BigInteger q, r;
+            divMod(a, b, q, r);
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    // Floor of the square root of a non-negative value (Newton iteration).
+    BigInteger sqrt() const {
+        if (isZero()) return BigInteger();
+        size_t half = (bitLength() + 1) / 2;
+        BigInteger x;
+        x.mag.assign(half / 32 + 1, 0);
+        x.mag[half / 32] = 1u << (half % 32);
+
+        BigInteger two = 2;
+        while (true) {
+            BigInteger q, r, y;
+            divMod(*this, x, q, r);
+            divMod(x + q, two, y, r);
+            if (!(y < x)) return x;
+            x = y;
+        }
+    }
+
+    double toDouble() const {
+        double v = 0;
+        for (size_t i = mag.size(); i-- > 0;) v = v * 4294967296.0 + mag[i];
+        return negative ? -v : v;
+    }
+
+    string toString() const {
+        if (mag.empty()) return "0";
+        vector<uint32_t> cur = mag;
+        string digits;
+        while (!cur.empty()) {
+            uint64_t rem = 0;
+            for (size_t i = cur.size(); i-- > 0;) {
+                uint64_t v = (rem << 32) | cur[i];
+                cur[i] = (uint32_t)(v / 1000000000u);
+                rem = v % 1000000000u;
+            }
+            while (!cur.empty() && cur.back() == 0) cur.pop_back();
+            for (int k = 0; k < 9 && (!cur.empty() || rem); k++) {
+                digits.push_back((char)('0' + rem % 10));
+                rem /= 10;
+            }
+        }
+        if (negative) digits.push_back('-');
+        reverse(digits.begin(), digits.end());
+        return digits;
+    }
+};
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef BLOCKEDSOLVER_H_
+#define BLOCKEDSOLVER_H_
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "Pivoting.h"
+#include "TriangularSolver.h"
+#include <algorithm>
+
+using namespace std;
+
+// Right-looking blocked LU with partial pivoting. Each panel of blockSize
+// columns is factored on its own, the matching block row of U is formed with
+// a unit-lower triangular solve, and the trailing matrix gets one rank-b
+// update tiled over columns so the U block stays in cache while every row
+// streams past it. The trailing update uses schedule(runtime) so callers can
+// tune it with omp_set_schedule.
+template <typename T>
+class BlockedSolver
+{
+private:
+    int blockSize;
+    double growthFactor;
+
+    static const int COLUMN_TILE = 256;
+
+    // Stops inside the panel [k0, k1) after pivots [k0, done): the columns
+    // right of the panel get the updates those pivots still owe them and
+    // the multipliers are dropped, so A stays equivalent to the equations.
+    static void abandonPanel(LinearSystem<T>* sys, Matrix<T>& A, int k0, int done, int k1, int n) {
+        for (int k = k0; k < done; k++) {
+            const T* uk = A[k];
+#pragma omp parallel for schedule(static)
+            for (int i = k + 1; i < n; i++) {
+                T* r = A[i];
+                T l = r[k];
+#pragma omp simd
+                for (int j = k1; j < n; j++) r[j] -= l * uk[j];
+            }
+        }
+        sys->clearMultipliers(done);
+    }
+
+public:
+    explicit BlockedSolver(int block = 64) : blockSize(block > 0 ? block : 64), growthFactor(0) {}
+
+    bool solve(LinearSystem<T>* sys) {
+        Matrix<T>& A = *sys->getMatrix();
+        Vector<T>& B = *sys->getConstants();
+        Vector<T>& X = *sys->getResult();
+
+        int n = sys->getSize();
+        growthFactor = 0;
+        if (n <= 0 || sys->getEquationCount() != n) return false;
+
+        double maxA = PivotSearch<T>::maxAbs(A, n, n);
+        double tolerance = EPSILON * maxA;
+        T* b = &B[0];
+
+        SolveControl* control = sys->getSolveControl();
+        int rowSign = 1;
+
+        for (int k0 = 0; k0 < n; k0 += blockSize) {
+            int k1 = min(k0 + blockSize, n);
+            if (control && control->checkpoint("elimination", k0, n)) {
+                abandonPanel(sys, A, k0, k0, k1, n);
+                return false;
+            }
+
+            for (int k = k0; k < k1; k++) {
+                PivotCandidate p = PivotSearch<T>::inColumn(A, k, k, n);
+                if (p.value <= tolerance) {
+                    abandonPanel(sys, A, k0, k, k1, n);
+                    return false;
+                }
+
+                if (p.row != k) {
+                    A.swapRows(k, p.row);
+                    std::swap(b[k], b[p.row]);
+                    rowSign = -rowSign;
+                }
+
+                const T* pivotRow = A[k];
+                T pivot = pivotRow[k];
+                T bk = b[k];
+
+#pragma omp parallel for schedule(static)
+                for (int i = k + 1; i < n; i++) {
+                    T* r = A[i];
+                    T l = r[k] / pivot;
+                    r[k] = l;
+                    for (int j = k + 1; j < k1; j++) r[j] -= l * pivotRow[j];
+                    b[i] -= l * bk;
+                }
+            }
+
+            if (k1 == n) break;
+
+            for (int k = k0; k < k1; k++) {
+                const T* uk = A[k];
+                for (int i = k + 1; i < k1; i++) {
+                    T* r = A[i];
+                    T l = r[k];
+#pragma omp simd
+                    for (int j = k1; j < n; j++) r[j] -= l * uk[j];
+                }
+            }
+
+            T** panelRows = new T * [k1 - k0];
+            for (int k = k0; k < k1; k++) panelRows[k - k0] = A[k];
+
+#pragma omp parallel for schedule(runtime)
+            for (int i = k1; i < n; i++) {
+                T* r = A[i];
+                for (int jt = k1; jt < n; jt += COLUMN_TILE) {
+                    int jEnd = min(jt + COLUMN_TILE, n);
+                    for (int k = k0; k < k1; k++) {
+                        T l = r[k];
+                        const T* uk = panelRows[k - k0];
+#pragma omp simd
+                        for (int j = jt; j < jEnd; j++) r[j] -= l * uk[j];
+                    }
+                }
+            }
+
+            delete[] panelRows;
+        }
+
+        growthFactor = maxA > 0 ? PivotSearch<T>::maxAbsUpper(A, n) / maxA : 0;
+
+        sys->clearMultipliers(n);
+        sys->recordDeterminant(rowSign);
+
+        for (int i = 0; i < n; i++) X[i] = b[i];
+        TriangularSolver<T>(blockSize).solveUpper(A, &X[0], n);
+
+        return true;
+    }
+
+    double getGrowthFactor() const { return growthFactor; }
+};
+
+#endif
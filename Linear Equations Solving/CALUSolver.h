@@ -0,0 +1,264 @@
+#ifndef CALUSOLVER_H_
+#define CALUSOLVER_H_
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "Pivoting.h"
+#include "TriangularSolver.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+using namespace std;
+
+// Communication-avoiding LU (CALU). Same right-looking blocked structure as
+// BlockedSolver, but a panel's pivot rows are chosen up front by tournament
+// pivoting: every thread runs partial pivoting on a copy of its own block of
+// rows and nominates blockSize candidates, then pairs of candidate sets play
+// off up a binary tree. That is log2(p) synchronizations per panel instead
+// of one reduction and one row swap per column. With the winners swapped to
+// the top, the panel is factored without further pivoting and every row
+// below computes its multipliers in a single parallel pass.
+template <typename T>
+class CALUSolver
+{
+private:
+    int blockSize;
+    double growthFactor;
+
+    static const int COLUMN_TILE = 256;
+
+    // Partial pivoting on copies of the panel columns [k0, k0 + w) of the
+    // given rows; returns the rows it pivoted on, in pivot order.
+    static vector<int> selectPivots(Matrix<T>& A, vector<int> ids, int k0, int w) {
+        int rows = (int)ids.size();
+        vector<T> buf((size_t)rows * w);
+        for (int r = 0; r < rows; r++) {
+            const T* src = A[ids[r]] + k0;
+            copy(src, src + w, buf.begin() + (size_t)r * w);
+        }
+
+        int steps = min(w, rows);
+        for (int c = 0; c < steps; c++) {
+            int best = c;
+            double bestVal = abs(buf[(size_t)c * w + c]);
+            for (int r = c + 1; r < rows; r++) {
+                double v = abs(buf[(size_t)r * w + c]);
+                if (v > bestVal) {
+                    bestVal = v;
+                    best = r;
+                }
+            }
+
+            if (best != c) {
+                swap_ranges(buf.begin() + (size_t)c * w, buf.begin() + (size_t)(c + 1) * w, buf.begin() + (size_t)best * w);
+                std::swap(ids[c], ids[best]);
+            }
+            if (bestVal == 0) continue;
+
+            const T* pr = &buf[(size_t)c * w];
+            for (int r = c + 1; r < rows; r++) {
+                T* row = &buf[(size_t)r * w];
+                T l = row[c] / pr[c];
+#pragma omp simd
+                for (int j = c + 1; j < w; j++) row[j] -= l * pr[j];
+            }
+        }
+
+        ids.resize(steps);
+        return ids;
+    }
+
+    // Pivot rows for the panel [k0, k0 + w) among rows [k0, n).
+    static vector<int> tournament(Matrix<T>& A, int k0, int w, int n) {
+        int rows = n - k0;
+        int leaves = 1;
+#ifdef _OPENMP
+        leaves = omp_get_max_threads();
+#endif
+        leaves = max(1, min(leaves, rows / w));
+
+        vector<vector<int>> winners(leaves);
+
+#pragma omp parallel for schedule(static)
+        for (int l = 0; l < leaves; l++) {
+            int r0 = k0 + (int)((long long)rows * l / leaves);
+            int r1 = k0 + (int)((long long)rows * (l + 1) / leaves);
+            vector<int> ids(r1 - r0);
+            for (int r = r0; r < r1; r++) ids[r - r0] = r;
+            winners[l] = selectPivots(A, ids, k0, w);
+        }
+
+        for (int stride = 1; stride < leaves; stride *= 2) {
+#pragma omp parallel for schedule(static)
+            for (int l = 0; l < leaves; l += 2 * stride) {
+                if (l + stride >= leaves) continue;
+                vector<int> ids = winners[l];
+                ids.insert(ids.end(), winners[l + stride].begin(), winners[l + stride].end());
+                winners[l] = selectPivots(A, ids, k0, w);
+            }
+        }
+
+        return winners[0];
+    }
+
+    // Stops inside the panel [k0, k1) after pivots [k0, done). Rows below
+    // the panel have not seen those pivots yet, and the columns right of it
+    // have not been updated; both are brought up to date before the
+    // multipliers are dropped, so A stays equivalent to the equations.
+    static void abandonPanel(LinearSystem<T>* sys, Matrix<T>& A, T* b, int k0, int done, int k1, int n) {
+#pragma omp parallel for schedule(static)
+        for (int i = k1; i < n; i++) {
+            T* r = A[i];
+            for (int k = k0; k < done; k++) {
+                const T* pivotRow = A[k];
+                T l = r[k] / pivotRow[k];
+                r[k] = l;
+                for (int j = k + 1; j < k1; j++) r[j] -= l * pivotRow[j];
+                b[i] -= l * b[k];
+            }
+        }
+
+        for (int k = k0; k < done; k++) {
+            const T* uk = A[k];
+#pragma omp parallel for schedule(static)
+            for (int i = k + 1; i < n; i++) {
+                T* r = A[i];
+                T l = r[k];
+#pragma omp simd
+                for (int j = k1; j < n; j++) r[j] -= l * uk[j];
+            }
+        }
+        sys->clearMultipliers(done);
+    }
+
+public:
+    explicit CALUSolver(int block = 64) : blockSize(block > 0 ? block : 64), growthFactor(0) {}
+
+    bool solve(LinearSystem<T>* sys) {
+        Matrix<T>& A = *sys->getMatrix();
+        Vector<T>& B = *sys->getConstants();
+        Vector<T>& X = *sys->getResult();
+
+        int n = sys->getSize();
+        growthFactor = 0;
+        if (n <= 0 || sys->getEquationCount() != n) return false;
+
+        double maxA = PivotSearch<T>::maxAbs(A, n, n);
+        double tolerance = EPSILON * maxA;
+        T* b = &B[0];
+
+        // occupant[p] is the original row now at position p, position[] the
+        // inverse; they turn tournament winners into row swaps.
+        vector<int> occupant(n), position(n);
+        SolveControl* control = sys->getSolveControl();
+        int rowSign = 1;
+
+        for (int k0 = 0; k0 < n; k0 += blockSize) {
+            int k1 = min(k0 + blockSize, n);
+            int w = k1 - k0;
+            if (control && control->checkpoint("elimination", k0, n)) {
+                abandonPanel(sys, A, b, k0, k0, k1, n);
+                return false;
+            }
+
+            vector<int> pivots = tournament(A, k0, w, n);
+
+            for (int p = k0; p < n; p++) {
+                occupant[p] = p;
+                position[p] = p;
+            }
+            for (int j = 0; j < w; j++) {
+                int target = k0 + j;
+                int from = position[pivots[j]];
+                if (from == target) continue;
+
+                A.swapRows(target, from);
+                std::swap(b[target], b[from]);
+                rowSign = -rowSign;
+
+                int moved = occupant[target];
+                occupant[from] = moved;
+                position[moved] = from;
+                occupant[target] = pivots[j];
+                position[pivots[j]] = target;
+            }
+
+            for (int k = k0; k < k1; k++) {
+                const T* pivotRow = A[k];
+                if (abs(pivotRow[k]) <= tolerance) {
+                    abandonPanel(sys, A, b, k0, k, k1, n);
+                    return false;
+                }
+
+                for (int i = k + 1; i < k1; i++) {
+                    T* r = A[i];
+                    T l = r[k] / pivotRow[k];
+                    r[k] = l;
+                    for (int j = k + 1; j < k1; j++) r[j] -= l * pivotRow[j];
+                    b[i] -= l * b[k];
+                }
+            }
+
+#pragma omp parallel for schedule(static)
+            for (int i = k1; i < n; i++) {
+                T* r = A[i];
+                T bi = b[i];
+                for (int k = k0; k < k1; k++) {
+                    const T* pivotRow = A[k];
+                    T l = r[k] / pivotRow[k];
+                    r[k] = l;
+                    for (int j = k + 1; j < k1; j++) r[j] -= l * pivotRow[j];
+                    bi -= l * b[k];
+                }
+                b[i] = bi;
+            }
+
+            if (k1 == n) break;
+
+            for (int k = k0; k < k1; k++) {
+                const T* uk = A[k];
+                for (int i = k + 1; i < k1; i++) {
+                    T* r = A[i];
+                    T l = r[k];
+#pragma omp simd
+                    for (int j = k1; j < n; j++) r[j] -= l * uk[j];
+                }
+            }
+
+            vector<T*> panelRows(w);
+            for (int k = k0; k < k1; k++) panelRows[k - k0] = A[k];
+
+#pragma omp parallel for schedule(runtime)
+            for (int i = k1; i < n; i++) {
+                T* r = A[i];
+                for (int jt = k1; jt < n; jt += COLUMN_TILE) {
+                    int jEnd = min(jt + COLUMN_TILE, n);
+                    for (int k = k0; k < k1; k++) {
+                        T l = r[k];
+                        const T* uk = panelRows[k - k0];
+#pragma omp simd
+                        for (int j = jt; j < jEnd; j++) r[j] -= l * uk[j];
+                    }
+                }
+            }
+        }
+
+        growthFactor = maxA > 0 ? PivotSearch<T>::maxAbsUpper(A, n) / maxA : 0;
+
+        sys->clearMultipliers(n);
+        sys->recordDeterminant(rowSign);
+
+        for (int i = 0; i < n; i++) X[i] = b[i];
+        TriangularSolver<T>(blockSize).solveUpper(A, &X[0], n);
+
+        return true;
+    }
+
+    // max|U| / max|A| from the last solve, comparable with partial pivoting.
+    double getGrowthFactor() const { return growthFactor; }
+};
+
+#endif
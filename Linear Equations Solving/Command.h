@@ -5,7 +5,12 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <csignal>
 #include "LinearSystem.h"
+#include "LapackSolver.h"
+#include "ModularSolver.h"
+#include "AsyncSolver.h"
 
 using namespace std;
 
@@ -14,31 +19,111 @@ class Command
 private:
     LinearSystem<double>* sys;
 
+    // The solve Ctrl-C should cancel; set only while one is running.
+    static atomic<SolveControl*>& interruptTarget() {
+        static atomic<SolveControl*> target(nullptr);
+        return target;
+    }
+
+    static void onInterrupt(int) {
+        SolveControl* control = interruptTarget().load();
+        if (control) control->cancel();
+    }
+
+    // Runs work through AsyncSolver with Ctrl-C bound to cancellation and an
+    // optional time limit. Solves that outlast a quarter second show their
+    // progress on one line, cleared before returning.
+    SolveStatus runInterruptible(function<bool(LinearSystem<double>*)> work, double seconds) {
+        auto control = make_shared<SolveControl>();
+        if (seconds > 0) control->setTimeout(seconds);
+
+        bool shown = false;
+        control->setProgressCallback([&shown](const SolveProgress& p) {
+            if (p.step == 0 || p.total <= 0) return;
+            cout << "\r" << p.phase << " " << p.step << " of " << p.total
+                << " (" << (int)(100.0 * p.step / p.total) << "%)";
+            if (p.residual >= 0) cout << ", residual " << p.residual;
+            cout << "   " << flush;
+            shown = true;
+        }, chrono::milliseconds(250));
+
+        interruptTarget().store(control.get());
+        void (*previous)(int) = signal(SIGINT, onInterrupt);
+
+        SolveStatus status = AsyncSolver<double>::start(sys, control, work).get();
+
+        signal(SIGINT, previous == SIG_ERR ? SIG_DFL : previous);
+        interruptTarget().store(nullptr);
+
+        if (shown) cout << "\r" << string(70, ' ') << "\r" << flush;
+        return status;
+    }
+
+    static void printStopped(SolveStatus status) {
+        cout << "Solve " << solveStatusMessage(status)
+            << "; the equations are left partially reduced but equivalent." << endl;
+    }
+
     void printRow(int rowIndex) {
         Matrix<double>* A = sys->getMatrix();
         Vector<double>* B = sys->getConstants();
         int n = sys->getSize();
 
+        const vector<int>& order = sys->getVariableOrder();
+
         int limit = (n > 20) ? 20 : n;
 
-        for (int j = 0; j < limit; j++) {
+        for (int k = 0; k < limit; k++) {
+            int j = order[k];
             double val = (*A)[rowIndex][j];
             if (val == 0) continue; 
 
-            if (j > 0 && val >= 0) cout << "+";
-            cout << val << "x" << (j + 1) << " ";
+            if (k > 0 && val >= 0) cout << "+";
+            cout << val << sys->variableName(j) << " ";
         }
 
         if (n > 20) cout << "... ";
-        cout << "= " << (*B)[rowIndex] << endl;
+        cout << "= " << (*B)[rowIndex] << '\n';
     }
 
 
+    bool isUpperTriangular() {
+        Matrix<double>* A = sys->getMatrix();
+        int n = sys->getSize();
+        bool upper = true;
+
+#pragma omp parallel for schedule(static) reduction(&&:upper)
+        for (int i = 1; i < n; i++) {
+            const double* r = (*A)[i];
+            for (int j = 0; j < i; j++) {
+                if (r[j] != 0) upper = false;
+            }
+        }
+        return upper;
+    }
+
     double calculateDeterminant() {
         int n = sys->getSize();
         Matrix<double>* mainMat = sys->getMatrix();
 
-        Matrix<double> temp(n, n);
+        // A solve already factored the matrix; its rows may be out of order,
+        // so only the recorded determinant has the right sign.
+        if (sys->hasDeterminant()) return sys->getLastDeterminant();
+
+        if (isUpperTriangular()) {
+            double det = 1.0;
+            for (int i = 0; i < n; i++) det *= (*mainMat)[i][i];
+            return det;
+        }
+
+        size_t copyBytes = mainMat->storageBytes() + n * sizeof(double*);
+        if (!sys->fitsMemoryLimit(copyBytes)) {
+            cout << "A copy of the matrix would exceed the memory limit; reducing the system in place "
+                << "(the equations stay equivalent)." << endl;
+            return sys->reduceForDeterminant();
+        }
+
+        Matrix<double> temp(n, n, sys->getPageMode());
 
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
@@ -46,6 +131,9 @@ private:
             }
         }
 
+#ifdef LINEAR_SOLVER_USE_LAPACK
+        return LapackSolver<double>().determinant(temp, n);
+#else
         double det = 1.0;
         for (int i = 0; i < n; i++) {
             int pivot = i;
@@ -70,6 +158,7 @@ private:
             }
         }
         return det;
+#endif
     }
 
 public:
@@ -96,13 +185,22 @@ public:
                     << left << setw(35) << "exit" << "- Exit the command interface\n"
                     << left << setw(35) << "num_vars" << "- Display the number of variables in the system\n"
                     << left << setw(35) << "equation <index>" << "- Display the equation at the specified index (1-based)\n"
-                    << left << setw(35) << "column <var_name>" << "- Display the coefficients of a specific variable (e.g., column x1)\n"
+                    << left << setw(35) << "column <var_name>" << "- Display the coefficients of a specific variable (e.g., column x1, column flow_a12)\n"
                     << left << setw(35) << "add <target> <source>" << "- Add source equation to target equation (modifies target)\n"
                     << left << setw(35) << "subtract <target> <source>" << "- Subtract source eq from target eq (modifies target)\n"
                     << left << setw(35) << "substitute <var> <tgt> <src>" << "- Eliminate <var> in <tgt> equation using <src> equation\n"
                     << left << setw(35) << "D" << "- Display the current state of the matrix/system\n"
                     << left << setw(35) << "D_value" << "- Calculate and display the determinant of the matrix\n"
-                    << left << setw(35) << "solve" << "- Solve the linear system and display the result\n"
+                    << left << setw(35) << "solve [seconds]" << "- Solve and display the result (Ctrl-C cancels; optional time limit)\n"
+                    << left << setw(35) << "solve_exact" << "- Solve exactly with modular elimination; prints fractions\n"
+                    << left << setw(35) << "export <file> [text|csv|bin]" << "- Write the last solution to a file\n"
+                    << left << setw(35) << "rhs <c1> <c2> ... <cm>" << "- Stream another column of constants for the same coefficients\n"
+                    << left << setw(35) << "solve_all [seconds]" << "- Solve for every constants column with one factorization\n"
+                    << left << setw(35) << "lstsq" << "- Least-squares / minimum-norm solve with a rank report\n"
+                    << left << setw(35) << "verify" << "- Residual and backward error of the last solution against the equations as entered\n"
+                    << left << setw(35) << "memory" << "- Show estimated peak memory, page backing and peak RSS\n"
+                    << left << setw(35) << "memory_limit <MB>" << "- Cap memory for transient copies (0 = unlimited)\n"
+                    << left << setw(35) << "pivot <partial|rook|complete>" << "- Select the pivoting strategy used by solve\n"
                     << "--------------------------\n";
             }
             else if (cmd == "num_vars") {
@@ -111,58 +209,59 @@ public:
             else if (cmd == "equation") {
                 int idx;
                 if (ss >> idx) {
-                    if (idx < 1 || idx > sys->getSize()) cout << "Invalid index.\n";
+                    if (idx < 1 || idx > sys->getEquationCount()) cout << "Invalid index.\n";
                     else printRow(idx - 1);
                 }
             }
             else if (cmd == "column") {
                 string varName;
                 ss >> varName;
-                size_t xPos = varName.find('x');
-                if (xPos != string::npos) {
-                    try {
-                        int colIdx = stoi(varName.substr(xPos + 1)) - 1;
-                        Matrix<double>* A = sys->getMatrix();
-                        if (colIdx >= 0 && colIdx < sys->getSize()) {
-                            int limit = (sys->getSize() > 20) ? 20 : sys->getSize();
-                            for (int i = 0; i < limit; i++) cout << (*A)[i][colIdx] << endl;
-                            if (sys->getSize() > 20) cout << "..." << endl;
-                        }
-                    }
-                    catch (...) { cout << "Invalid column format." << endl; }
+                int colIdx = sys->findVariable(varName);
+                if (colIdx < 0) {
+                    cout << "Unknown variable: " << varName << endl;
+                }
+                else {
+                    Matrix<double>* A = sys->getMatrix();
+                    int rows = sys->getEquationCount();
+                    int limit = (rows > 20) ? 20 : rows;
+                    for (int i = 0; i < limit; i++) cout << (*A)[i][colIdx] << endl;
+                    if (rows > 20) cout << "..." << endl;
                 }
             }
 
             else if (cmd == "add" || cmd == "subtract") {
                 int i, j;
                 if (ss >> i >> j) {
-                    Matrix<double>* A = sys->getMatrix();
-                    Vector<double>* B = sys->getConstants();
-                    int r1 = i - 1;
-                    int r2 = j - 1;
-                    int n = sys->getSize();
-
-                    for (int k = 0; k < n; k++) {
-                        if (cmd == "add") (*A)[r1][k] += (*A)[r2][k];
-                        else              (*A)[r1][k] -= (*A)[r2][k];
+                    int count = sys->getEquationCount();
+                    if (i < 1 || i > count || j < 1 || j > count) {
+                        cout << "Invalid index.\n";
                     }
-                    if (cmd == "add") (*B)[r1] += (*B)[r2];
-                    else              (*B)[r1] -= (*B)[r2];
+                    else {
+                        int r1 = i - 1;
+                        int r2 = j - 1;
+                        sys->combineRows(r1, r2, cmd == "add" ? 1.0 : -1.0);
 
-                    printRow(r1);
+                        printRow(r1);
+                    }
                 }
             }
             else if (cmd == "substitute") {
                 string varName;
                 int targetEq, srcEq;
                 if (ss >> varName >> targetEq >> srcEq) {
-                    try {
-                        int colIdx = stoi(varName.substr(varName.find('x') + 1)) - 1;
+                    int colIdx = sys->findVariable(varName);
+                    int count = sys->getEquationCount();
+                    if (colIdx < 0) {
+                        cout << "Unknown variable: " << varName << endl;
+                    }
+                    else if (targetEq < 1 || targetEq > count || srcEq < 1 || srcEq > count) {
+                        cout << "Invalid index.\n";
+                    }
+                    else {
                         int tIdx = targetEq - 1;
                         int sIdx = srcEq - 1;
 
                         Matrix<double>* A = sys->getMatrix();
-                        Vector<double>* B = sys->getConstants();
 
                         double pivot = (*A)[sIdx][colIdx];
                         if (abs(pivot) < 1e-9) {
@@ -170,18 +269,13 @@ public:
                         }
                         else {
                             double factor = (*A)[tIdx][colIdx] / pivot;
-
-                            for (int k = 0; k < sys->getSize(); k++) {
-                                (*A)[tIdx][k] -= factor * (*A)[sIdx][k];
-                            }
-                            (*B)[tIdx] -= factor * (*B)[sIdx];
+                            sys->combineRows(tIdx, sIdx, -factor);
 
                             (*A)[tIdx][colIdx] = 0.0;
 
                             printRow(tIdx);
                         }
                     }
-                    catch (...) { cout << "Invalid syntax." << endl; }
                 }
             }
 
@@ -190,18 +284,144 @@ public:
                 sys->printSolution();
             }
             else if (cmd == "D_value") {
-                cout << "Calculating Determinant (this may take a moment)..." << endl;
-                cout << "Determinant: " << calculateDeterminant() << endl;
+                if (sys->getEquationCount() != sys->getSize()) {
+                    cout << "Determinant is only defined for square systems." << endl;
+                }
+                else {
+                    cout << "Calculating Determinant (this may take a moment)..." << endl;
+                    double det = calculateDeterminant() * sys->variableOrderSign();
+                    cout << "Determinant: " << det << endl;
+                }
             }
             else if (cmd == "solve") {
-                cout << "Solving system..." << endl;
-                if (sys->solve()) {
+                double seconds = 0;
+                ss >> seconds;
+                cout << "Solving system... (Ctrl-C cancels)" << endl;
+                SolveStatus status = runInterruptible([](LinearSystem<double>* s) { return s->solve(); }, seconds);
+                if (status == SolveStatus::Solved) {
+                    sys->verify();
                     sys->printSolution();
+                    cout << "Growth factor (" << pivotStrategyName(sys->getPivotStrategy()) << " pivoting): "
+                        << sys->getGrowthFactor() << endl;
+                }
+                else if (status != SolveStatus::NoUniqueSolution) {
+                    printStopped(status);
+                }
+                else {
+                    cout << "System has no unique solution. Use 'lstsq' for a least-squares / minimum-norm solution." << endl;
+                }
+            }
+            else if (cmd == "solve_exact") {
+                cout << "Solving system exactly..." << endl;
+                ModularSolver<double> exact;
+                ExactStatus status = exact.solve(sys);
+                if (status == ExactStatus::Solved) {
+                    string text = "\n--- Exact Solution ---\n";
+                    for (int col : sys->getVariableOrder()) {
+                        text += sys->variableName(col) + " = " + exact.valueString(col) + "\n";
+                    }
+                    text += "----------------------\n\n";
+                    SolutionWriter<double>::writeStdoutText(text.c_str());
+                    cout << "Primes used: " << exact.getPrimesUsed() << endl;
+                }
+                else {
+                    cout << "No exact solution: " << exactStatusMessage(status) << "." << endl;
+                }
+            }
+            else if (cmd == "rhs") {
+                string values;
+                getline(ss, values);
+                if (sys->addConstantColumn(values)) {
+                    cout << "Constants column " << sys->getConstantColumnCount() << " added." << endl;
+                }
+                else {
+                    cout << "Error: " << sys->getLastErrorMessage() << endl;
+                }
+            }
+            else if (cmd == "solve_all") {
+                double seconds = 0;
+                ss >> seconds;
+                cout << "Solving " << sys->getConstantColumnCount() << " constants column(s)... (Ctrl-C cancels)" << endl;
+                SolveStatus status = runInterruptible([](LinearSystem<double>* s) { return s->solveAll(); }, seconds);
+                if (status == SolveStatus::Solved) {
+                    sys->verify();
+                    sys->printAllSolutions();
+                }
+                else if (status != SolveStatus::NoUniqueSolution) {
+                    printStopped(status);
                 }
                 else {
                     cout << "System has no unique solution." << endl;
                 }
             }
+            else if (cmd == "lstsq") {
+                cout << "Solving system in the least-squares sense..." << endl;
+                if (sys->solveLeastSquares()) {
+                    sys->verify();
+                    sys->printSolution();
+                    cout << "Rank: " << sys->getRank() << " of " << sys->getSize() << " variables";
+                    if (sys->getRank() < sys->getSize()) cout << " (minimum-norm solution)";
+                    cout << endl;
+                    cout << "Residual ||Ax - b||: " << sys->getResidualNorm() << endl;
+                }
+                else {
+                    cout << "All coefficients are zero; nothing to solve." << endl;
+                }
+            }
+            else if (cmd == "verify") {
+                if (!sys->verify()) {
+                    cout << "Nothing to verify: the equations as entered were not kept." << endl;
+                }
+                else {
+                    const VerificationReport& r = sys->getVerification();
+                    cout << "Equations checked:    " << r.rows << endl;
+                    cout << "||Ax - b|| (inf / 2): " << r.residualMax << " / " << r.residualTwo << endl;
+                    cout << "||A||, ||x||, ||b||:  " << r.matrixNorm << ", " << r.solutionNorm << ", " << r.rhsNorm << endl;
+                    cout << "Backward error:       " << r.backwardError << endl;
+                }
+            }
+            else if (cmd == "export") {
+                string path, formatName = "text";
+                SolutionFormat format;
+                ss >> path >> formatName;
+                if (path.empty() || !parseSolutionFormat(formatName, format)) {
+                    cout << "Usage: export <file> [text|csv|bin]" << endl;
+                }
+                else if (sys->exportSolution(path, format)) {
+                    cout << "Solution written to " << path << endl;
+                }
+                else {
+                    cout << "Could not write " << path << endl;
+                }
+            }
+            else if (cmd == "memory") {
+                cout << "Estimated peak for this system: " << MemoryBudget::formatBytes(sys->estimatePeakBytes()) << endl;
+                cout << "Matrix backing: " << pageModeName(sys->getPageMode()) << endl;
+                cout << "Memory limit: "
+                    << (sys->getMemoryLimit() ? MemoryBudget::formatBytes(sys->getMemoryLimit()) : string("unlimited")) << endl;
+                cout << "Peak RSS so far: " << MemoryBudget::formatBytes(MemoryBudget::peakResidentBytes()) << endl;
+            }
+            else if (cmd == "memory_limit") {
+                double mb;
+                if (ss >> mb && mb >= 0) {
+                    sys->setMemoryLimit((size_t)(mb * 1024 * 1024));
+                    cout << "Memory limit set." << endl;
+                }
+                else {
+                    cout << "Usage: memory_limit <MB>" << endl;
+                }
+            }
+            else if (cmd == "pivot") {
+                string name;
+                PivotStrategy strategy;
+                if (ss >> name && parsePivotStrategy(name, strategy)) {
+                    sys->setPivotStrategy(strategy);
+                    cout << "Pivoting strategy set to " << pivotStrategyName(strategy) << "." << endl;
+                }
+                else {
+                    cout << "Usage: pivot <partial|rook|complete>" << endl;
+                }
+            }
             else {
                 cout << "Unknown command. Type 'help' to see available commands." << endl;
             }
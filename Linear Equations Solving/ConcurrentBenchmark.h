@@ -0,0 +1,148 @@
+#ifndef CONCURRENTBENCHMARK_H_
+#define CONCURRENTBENCHMARK_H_
+
+#include "LinearSystem.h"
+#include "SolverBackend.h"
+#include "EquationGenerator.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <omp.h>
+
+using namespace std;
+
+struct ConcurrentResult {
+    int workers;
+    int solves;
+    double seconds;
+    double solvesPerSecond;
+    double speedup;
+    double efficiency;
+};
+
+// Throughput of independent solves sharing one process. Every worker is a
+// std::thread with its own LinearSystem, generator and backend instance and
+// a one-thread OpenMP team, so the only thing the workers share is the
+// machine; with no global state in the solve path, solves per second should
+// grow linearly with the worker count until cores or memory bandwidth run
+// out. Worker w's k-th system is generated from seed (w * solvesPerWorker
+// + k), so every configuration solves the same kind of work.
+template <typename T>
+class ConcurrentBenchmark
+{
+private:
+    vector<ConcurrentResult> results;
+    int size;
+    string backendName;
+
+public:
+    ConcurrentBenchmark() : size(0) {}
+
+    // Generates, parses and solves one n x n system from 'seed' on the
+    // calling thread; false when it is singular or the backend is unknown.
+    static bool solveOne(int n, unsigned seed, const string& backend, vector<T>& x) {
+        shared_ptr<SolverBackend<T>> solver = SolverRegistry<T>::find(backend);
+        if (!solver) return false;
+
+        EquationGenerator gen(seed);
+        vector<string> lines(n);
+        for (int i = 0; i < n; i++) lines[i] = gen.generateMixedEquation(n);
+
+        LinearSystem<T> sys(n, n);
+        if (sys.addEquations(lines) != n) return false;
+
+        TuningParams params = { 64, 1, false };
+        if (!solver->run(&sys, params)) return false;
+
+        Vector<T>& result = *sys.getResult();
+        x.assign(n, 0);
+        for (int i = 0; i < n; i++) x[i] = result[i];
+        return true;
+    }
+
+    // Runs 'workers' threads of solvesPerWorker solves each; returns the
+    // wall time, or a negative value if any solve failed.
+    static double timeWorkers(int workers, int n, int solvesPerWorker, const string& backend) {
+        atomic<int> failures(0);
+        vector<thread> pool;
+
+        auto start = chrono::steady_clock::now();
+        for (int w = 0; w < workers; w++) {
+            pool.emplace_back([&failures, w, n, solvesPerWorker, backend]() {
+#ifdef _OPENMP
+                omp_set_num_threads(1);
+#endif
+                vector<T> x;
+                for (int k = 0; k < solvesPerWorker; k++) {
+                    if (!solveOne(n, (unsigned)(w * solvesPerWorker + k), backend, x)) failures++;
+                }
+            });
+        }
+        for (thread& t : pool) t.join();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        return failures.load() == 0 ? elapsed.count() : -1;
+    }
+
+    // Worker counts 1, 2, 4, ... up to maxWorkers (always included).
+    bool run(int n, int solvesPerWorker, int maxWorkers, const string& backend = "parallel") {
+        results.clear();
+        size = n;
+        backendName = backend;
+
+        vector<int> counts;
+        for (int w = 1; w < maxWorkers; w *= 2) counts.push_back(w);
+        counts.push_back(maxWorkers);
+
+        cout << left << setw(10) << "workers" << setw(10) << "solves" << setw(12) << "seconds"
+            << setw(12) << "solves/s" << setw(10) << "speedup" << "efficiency" << endl;
+
+        double baseRate = 0;
+        for (int workers : counts) {
+            double t = timeWorkers(workers, n, solvesPerWorker, backend);
+            if (t < 0) {
+                cout << "A solve failed with " << workers << " workers; stopping." << endl;
+                return false;
+            }
+
+            int solves = workers * solvesPerWorker;
+            double rate = solves / t;
+            if (baseRate == 0) baseRate = rate;
+            ConcurrentResult r = { workers, solves, t, rate, rate / baseRate, rate / baseRate / workers };
+            results.push_back(r);
+
+            cout << left << setw(10) << r.workers << setw(10) << r.solves
+                << fixed << setprecision(4) << setw(12) << r.seconds
+                << setprecision(2) << setw(12) << r.solvesPerSecond << setw(10) << r.speedup
+                << r.efficiency * 100 << "%" << defaultfloat << endl;
+        }
+        return true;
+    }
+
+    bool writeJson(const string& path) const {
+        ofstream out(path);
+        if (!out) return false;
+
+        out << "{\n  \"n\": " << size << ",\n  \"backend\": \"" << backendName << "\",\n";
+        out << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const ConcurrentResult& r = results[i];
+            out << "    { \"workers\": " << r.workers << ", \"solves\": " << r.solves << ", \"seconds\": " << r.seconds
+                << ", \"solves_per_second\": " << r.solvesPerSecond << ", \"speedup\": " << r.speedup
+                << ", \"efficiency\": " << r.efficiency << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return true;
+    }
+
+    const vector<ConcurrentResult>& getResults() const { return results; }
+};
+
+#endif
@@ -3,133 +3,176 @@
 
 #include <iostream>
 #include <string>
-#include <sstream>
-#include <stdexcept>
+#include <cstdlib>
 #include "Vector.h"
 
 using namespace std;
 
+enum class ParseStatus { Ok, InvalidCharacter, MissingEquals, MultipleEquals, BadTerm };
+
+// A variable name is [A-Za-z_][A-Za-z0-9_]*; terms point at it inside the
+// equation's own text instead of carrying a copy or a position.
 struct Term {
-    int index;
+    int nameOffset;
+    int nameLength;
     double value;
 };
 
 class Equation
 {
 private:
+    string text;
     Vector<Term> terms;
     double constant;
+    ParseStatus status;
+    char invalidChar;
 
-    bool isDigit(char c) {
+    static bool isDigit(char c) {
         return (c >= '0' && c <= '9');
     }
 
-    void addOrUpdateTerm(int index, double val) {
-        int pos = index - 1;
+    static bool isNameStart(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
 
-        if (pos < 0) return;
+    static bool isNameChar(char c) {
+        return isNameStart(c) || isDigit(c);
+    }
 
-        while (terms.getSize() <= pos) {
-            terms.push({ terms.getSize() + 1, 0.0 });
-        }
+    // Length of the number at text[begin, end): digits with an optional
+    // fraction, then an exponent only if digits follow the 'e', so 1e-5 is
+    // a number and 2ex1 is 2 times ex1.
+    size_t numberLength(size_t begin, size_t end) const {
+        size_t i = begin;
+        bool digits = false;
+        while (i < end && (isDigit(text[i]) || text[i] == '.')) digits |= isDigit(text[i++]);
+        if (!digits || i == end || (text[i] != 'e' && text[i] != 'E')) return i - begin;
+
+        size_t exponent = i + 1;
+        if (exponent < end && (text[exponent] == '+' || text[exponent] == '-')) exponent++;
+        if (exponent == end || !isDigit(text[exponent])) return i - begin;
+        while (exponent < end && isDigit(text[exponent])) exponent++;
+        return exponent - begin;
+    }
 
-        terms[pos].value += val;
-        terms[pos].index = index;
+    // True when the sign at text[i] is the exponent sign of a number that
+    // starts the term at 'start', as in 1e-5.
+    bool isExponentSign(size_t start, size_t i) const {
+        if (i + 1 >= text.size() || !isDigit(text[i + 1])) return false;
+        if (text[start] == '+' || text[start] == '-') start++;
+        return i > start && numberLength(start, text.size()) > i + 1 - start;
     }
 
-    void parseTerm(string token, bool isRHS) {
-        if (token.empty()) return;
+    // Parses text[begin, end): an optional signed coefficient followed by a
+    // name, or a plain number.
+    bool parseTerm(size_t begin, size_t end, bool isRHS) {
+        if (begin == end) return true;
 
-        size_t xPos = token.find('x');
+        size_t nameStart = begin;
+        if (text[nameStart] == '+' || text[nameStart] == '-') nameStart++;
+        nameStart += numberLength(nameStart, end);
+        if (nameStart < end && !isNameStart(text[nameStart])) return false;
 
-        if (xPos != string::npos) {
-            string coeffStr = token.substr(0, xPos);
-            double coeff = (coeffStr.empty() || coeffStr == "+") ? 1.0 :
-                (coeffStr == "-") ? -1.0 : stod(coeffStr);
+        string coeffStr = text.substr(begin, nameStart - begin);
 
-            if (xPos + 1 < token.length()) {
-                int index = stoi(token.substr(xPos + 1));
+        if (nameStart == end) {
+            char* stop;
+            double val = strtod(coeffStr.c_str(), &stop);
+            if (coeffStr.empty() || *stop != '\0') return false;
 
-                if (isRHS) coeff = -coeff;
+            if (!isRHS) val = -val;
 
-                addOrUpdateTerm(index, coeff);
-            }
+            constant += val;
+            return true;
         }
-        else {
-            double val = stod(token);
 
-            if (!isRHS) val = -val;
+        for (size_t i = nameStart; i < end; i++) {
+            if (!isNameChar(text[i])) return false;
+        }
 
-            constant += val;
+        double coeff;
+        if (coeffStr.empty() || coeffStr == "+") coeff = 1.0;
+        else if (coeffStr == "-") coeff = -1.0;
+        else {
+            char* stop;
+            coeff = strtod(coeffStr.c_str(), &stop);
+            if (*stop != '\0') return false;
         }
+
+        if (isRHS) coeff = -coeff;
+
+        terms.push({ (int)nameStart, (int)(end - nameStart), coeff });
+        return true;
     }
 public:
 
-    Equation() : terms(0), constant(0) {}
+    Equation() : terms(0), constant(0), status(ParseStatus::Ok), invalidChar(0) {}
 
-    bool parse(string line) {
+    // Never prints, so lines can be parsed concurrently; callers that talk
+    // to a user show errorMessage() themselves.
+    ParseStatus parse(const string& line) {
         int eqCount = 0;
         for (char c : line) {
             if (c == '=') {
                 eqCount++;
             }
-            if (!isDigit(c) && c != ' ' && c != '+' && c != '-' &&
-                c != '=' && c != '.' && c != 'x') {
-
-                cout << "\n[Error] Invalid character detected: '" << c << "'\n"
-                    << "Only numbers, standard variables (x1, x2), and operators are allowed.\n";
-                return false;
+            if (!isNameChar(c) && c != ' ' && c != '+' && c != '-' &&
+                c != '=' && c != '.') {
+                invalidChar = c;
+                return status = ParseStatus::InvalidCharacter;
             }
         }
 
-        if (eqCount == 0) {
-            cout << "\n[Error] Invalid format: Missing '=' sign in equation.\n";
-            return false;
-        }
-        if (eqCount > 1) {
-            cout << "\n[Error] Invalid format: Multiple '=' signs detected.\n";
-            return false;
-        }
-
-        string leftPart, rightPart;
-        size_t eqPos = line.find('=');
-        leftPart = line.substr(0, eqPos);
-        rightPart = line.substr(eqPos + 1);
+        if (eqCount == 0) return status = ParseStatus::MissingEquals;
+        if (eqCount > 1) return status = ParseStatus::MultipleEquals;
 
-        auto tokenize = [&](const string& s, bool isRight) {
-            string currentTerm;
-            currentTerm.reserve(16);
+        text.clear();
+        text.reserve(line.size());
+        for (char c : line) {
+            if (c != ' ') text += c;
+        }
+        terms = Vector<Term>(0);
+        constant = 0;
 
-            for (char c : s) {
-                if (c == ' ') continue;
+        size_t eqPos = text.find('=');
 
-                if ((c == '+' || c == '-') && !currentTerm.empty()) {
-                    parseTerm(currentTerm, isRight);
-                    currentTerm.clear();
+        auto tokenize = [&](size_t from, size_t to, bool isRight) {
+            size_t start = from;
+            for (size_t i = from; i < to; i++) {
+                if ((text[i] == '+' || text[i] == '-') && i > start && !isExponentSign(start, i)) {
+                    if (!parseTerm(start, i, isRight)) return false;
+                    start = i;
                 }
-
-                currentTerm += c;
-            }
-
-            if (!currentTerm.empty()) {
-                parseTerm(currentTerm, isRight);
             }
+            return parseTerm(start, to, isRight);
             };
 
-        try {
-            tokenize(leftPart, false);
-            tokenize(rightPart, true);
-        }
-        catch (const exception& e) {
-            cout << "\n[Error] Failed to parse terms. Please check your math syntax.\n";
-            return false; 
+        if (!tokenize(0, eqPos, false) || !tokenize(eqPos + 1, text.size(), true)) {
+            return status = ParseStatus::BadTerm;
         }
 
-        return true;
+        return status = ParseStatus::Ok;
+    }
+
+    ParseStatus getStatus() const { return status; }
+
+    // What went wrong with the last parse, worded for the user.
+    string errorMessage() const {
+        switch (status) {
+        case ParseStatus::InvalidCharacter:
+            return string("Invalid character detected: '") + invalidChar + "'\n"
+                + "Only numbers, variable names (x1, flow_a12), and operators are allowed.";
+        case ParseStatus::MissingEquals: return "Invalid format: Missing '=' sign in equation.";
+        case ParseStatus::MultipleEquals: return "Invalid format: Multiple '=' signs detected.";
+        case ParseStatus::BadTerm: return "Failed to parse terms. Please check your math syntax.";
+        default: return "";
+        }
     }
 
     Vector<Term>& getTerms() { return terms; }
 
+    const char* nameOf(const Term& t) const { return text.data() + t.nameOffset; }
+
     double getConstant() const { return constant; }
 
     void print() {
@@ -137,10 +180,10 @@ public:
 
         for (int i = 0; i < terms.getSize(); i++) {
             Term t = terms[i];
-            cout << t.value << "x" << t.index << " ";
+            cout << t.value << text.substr(t.nameOffset, t.nameLength) << " ";
         }
         cout << " | Constant: " << constant << endl;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,3 +1,6 @@
+#ifndef EQUATIONGENERATOR_H_
+#define EQUATIONGENERATOR_H_
+
 #include <iostream>
 #include <string>
 #include <random>
@@ -7,15 +10,19 @@
 
 using namespace std;
 
+// Each generator owns its engine, so generators on different threads never
+// share state; a fixed seed reproduces the same equations.
 class EquationGenerator {
 private:
+    std::mt19937 generator;
+
     int getRand(int min, int max) {
-        static std::mt19937 generator(std::random_device{}());
         std::uniform_int_distribution<int> distribution(min, max);
         return distribution(generator);
     }
 
 public:
+    explicit EquationGenerator(unsigned seed = std::random_device{}()) : generator(seed) {}
 
     string generateMixedEquation(int numVars) {
         ostringstream ss;
@@ -38,4 +45,20 @@ public:
 
         return ss.str();
     }
-};
\ No newline at end of file
+
+    // Row 'index' of the 5-point Laplacian on a gridSize x gridSize grid
+    // with zero boundary values and unit load, unknowns named u1..u(k*k):
+    // 4u_c - (neighbours inside the grid) = 1. Symmetric positive definite,
+    // the model problem for the sparse multigrid solver.
+    string generateLaplacianEquation(int index, int gridSize) {
+        int row = index / gridSize, col = index % gridSize;
+        string s = "4u" + to_string(index + 1);
+        if (row > 0) s += "-u" + to_string(index - gridSize + 1);
+        if (col > 0) s += "-u" + to_string(index);
+        if (col + 1 < gridSize) s += "-u" + to_string(index + 2);
+        if (row + 1 < gridSize) s += "-u" + to_string(index + gridSize + 1);
+        return s + "=1";
+    }
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "LinearSystem.h"
 #include "Matrix.h"
 #include "Vector.h"
+#include "TriangularSolver.h"
 #include <cmath> // for std::abs
 
 using namespace std;
@@ -12,15 +13,24 @@ template <typename T>
 class GaussianSolver
 {
 public:
-    void solve(LinearSystem<T>* sys) {
+    bool solve(LinearSystem<T>* sys) {
 
         Matrix<T>* A = sys->getMatrix();
         Vector<T>* B = sys->getConstants();
         Vector<T>* X = sys->getResult(); 
 
         int n = sys->getSize();
+        if (sys->getEquationCount() != n) return false;
+
+        double tolerance = EPSILON * PivotSearch<T>::maxAbs(*A, n, n);
+        SolveControl* control = sys->getSolveControl();
+        int rowSign = 1;
 
         for (int k = 0; k < n; k++) {
+            if (control && control->checkpoint("elimination", k, n)) {
+                if (k > 0) sys->markReduced();
+                return false;
+            }
 
             int maxRow = k;
             for (int i = k + 1; i < n; i++) {
@@ -30,6 +40,7 @@ public:
             }
 
 
+            if (maxRow != k) rowSign = -rowSign;
             for (int j = k; j < n; j++) {
                 T temp = (*A)[k][j];
                 (*A)[k][j] = (*A)[maxRow][j];
@@ -41,8 +52,9 @@ public:
             (*B)[maxRow] = tempB;
 
 
-            if (abs((*A)[k][k]) < 1e-9) {
-                continue;
+            if (abs((*A)[k][k]) <= tolerance) {
+                sys->markReduced();
+                return false;
             }
 
             for (int i = k + 1; i < n; i++) {
@@ -59,15 +71,13 @@ public:
         }
 
 
-        for (int i = n - 1; i >= 0; i--) {
-            double sum = 0;
+        sys->markReduced();
+        sys->recordDeterminant(rowSign);
+        for (int i = 0; i < n; i++) (*X)[i] = (*B)[i];
 
-            for (int j = i + 1; j < n; j++) {
-                sum += (*A)[i][j] * (*X)[j];
-            }
+        TriangularSolver<T>().solveUpper(*A, &(*X)[0], n);
 
-            (*X)[i] = ((*B)[i] - sum) / (*A)[i][i];
-        }
+        return true;
     }
 };
 
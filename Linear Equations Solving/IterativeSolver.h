@@ -0,0 +1,90 @@
+#ifndef ITERATIVESOLVER_H_
+#define ITERATIVESOLVER_H_
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Jacobi iteration. Converges for strictly diagonally dominant systems, which
+// is the only structure it is dispatched for; every sweep is one parallel
+// pass over the rows and A is left untouched.
+template <typename T>
+class JacobiSolver
+{
+private:
+    int maxIterations;
+    double tolerance;
+    int iterations;
+
+public:
+    JacobiSolver(int maxIter = 1000, double tol = 1e-12)
+        : maxIterations(maxIter), tolerance(tol), iterations(0) {
+    }
+
+    bool solve(LinearSystem<T>* sys) {
+        Matrix<T>& A = *sys->getMatrix();
+        Vector<T>& B = *sys->getConstants();
+        Vector<T>& X = *sys->getResult();
+
+        int n = sys->getSize();
+        iterations = 0;
+        if (n <= 0 || sys->getEquationCount() != n) return false;
+
+        for (int i = 0; i < n; i++) {
+            if (A[i][i] == 0) return false;
+        }
+
+        T* x = new T[n];
+        T* next = new T[n];
+        const T* b = &B[0];
+        for (int i = 0; i < n; i++) x[i] = b[i] / A[i][i];
+
+        SolveControl* control = sys->getSolveControl();
+        double lastDelta = -1;
+
+        bool converged = false;
+        while (iterations < maxIterations) {
+            if (control && control->checkpoint("iteration", iterations, maxIterations, lastDelta)) break;
+            double maxDelta = 0, maxX = 0;
+
+#pragma omp parallel for schedule(static) reduction(max:maxDelta, maxX)
+            for (int i = 0; i < n; i++) {
+                const T* r = A[i];
+                T sum = 0;
+#pragma omp simd reduction(+:sum)
+                for (int j = 0; j < n; j++) sum += r[j] * x[j];
+                sum -= r[i] * x[i];
+
+                next[i] = (b[i] - sum) / r[i];
+                maxDelta = max(maxDelta, (double)abs(next[i] - x[i]));
+                maxX = max(maxX, (double)abs(next[i]));
+            }
+
+            std::swap(x, next);
+            iterations++;
+            lastDelta = maxDelta;
+
+            if (!std::isfinite(maxDelta)) break;
+            if (maxDelta <= tolerance * max(maxX, 1.0)) {
+                converged = true;
+                break;
+            }
+        }
+
+        if (converged) {
+            for (int i = 0; i < n; i++) X[i] = x[i];
+        }
+
+        delete[] next;
+        delete[] x;
+        return converged;
+    }
+
+    int getIterations() const { return iterations; }
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef LAPACKSOLVER_H_
+#define LAPACKSOLVER_H_
+
+#ifdef LINEAR_SOLVER_USE_LAPACK
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include <cmath>
+#include <cstddef>
+
+using namespace std;
+
+// Fortran passes the length of every CHARACTER argument as a hidden
+// trailing argument; gfortran-built LAPACKs read it, so it is declared and
+// passed (1 for trans) rather than left to whatever is in the register.
+typedef size_t lapack_strlen;
+
+extern "C" {
+    void dgetrf_(int* m, int* n, double* a, int* lda, int* ipiv, int* info);
+    void dgetrs_(char* trans, int* n, int* nrhs, double* a, int* lda, int* ipiv,
+        double* b, int* ldb, int* info, lapack_strlen transLength);
+    void sgetrf_(int* m, int* n, float* a, int* lda, int* ipiv, int* info);
+    void sgetrs_(char* trans, int* n, int* nrhs, float* a, int* lda, int* ipiv,
+        float* b, int* ldb, int* info, lapack_strlen transLength);
+}
+
+inline void lapackGetrf(int* m, int* n, double* a, int* lda, int* ipiv, int* info) {
+    dgetrf_(m, n, a, lda, ipiv, info);
+}
+inline void lapackGetrf(int* m, int* n, float* a, int* lda, int* ipiv, int* info) {
+    sgetrf_(m, n, a, lda, ipiv, info);
+}
+inline void lapackGetrs(char* trans, int* n, int* nrhs, double* a, int* lda, int* ipiv,
+    double* b, int* ldb, int* info) {
+    dgetrs_(trans, n, nrhs, a, lda, ipiv, b, ldb, info, 1);
+}
+inline void lapackGetrs(char* trans, int* n, int* nrhs, float* a, int* lda, int* ipiv,
+    float* b, int* ldb, int* info) {
+    sgetrs_(trans, n, nrhs, a, lda, ipiv, b, ldb, info, 1);
+}
+
+// Routes factorization, triangular solves and the determinant through the
+// vendor getrf/getrs. solve() factors a column-major copy of A, so getrf
+// sees A itself (P A = L U), and then leaves U in A and L^-1 P b in B: the
+// same system in upper-triangular form, as the in-tree solvers leave it.
+// determinant() factors the row-major storage of A in place, which is A^T
+// in column-major order; det(A^T) = det(A).
+template <typename T>
+class LapackSolver
+{
+private:
+    int* ipiv;
+    T* lu;
+    int n;
+    bool factored;
+
+    T* storage(Matrix<T>& A, bool& copied) {
+        T* data = A.contiguousData();
+        copied = (data == nullptr);
+        if (!copied) return data;
+
+        data = new T[(size_t)n * n];
+        for (int i = 0; i < n; i++) {
+            const T* r = A[i];
+            for (int j = 0; j < n; j++) data[(size_t)i * n + j] = r[j];
+        }
+        return data;
+    }
+
+    void release(Matrix<T>& A, T* data, bool copied) {
+        if (!copied) return;
+        for (int i = 0; i < n; i++) {
+            T* r = A[i];
+            for (int j = 0; j < n; j++) r[j] = data[(size_t)i * n + j];
+        }
+        delete[] data;
+    }
+
+public:
+    LapackSolver() : ipiv(nullptr), lu(nullptr), n(0), factored(false) {}
+    ~LapackSolver() {
+        delete[] ipiv;
+        delete[] lu;
+    }
+
+    // Factors a column-major copy of A; A itself is not touched. Returns
+    // false when getrf reports an exactly zero or sub-EPSILON pivot.
+    bool factor(Matrix<T>& A, int size) {
+        n = size;
+        delete[] ipiv;
+        delete[] lu;
+        ipiv = new int[n > 0 ? n : 1];
+        lu = new T[n > 0 ? (size_t)n * n : 1];
+        factored = false;
+        if (n <= 0) return false;
+
+        double tolerance = EPSILON * PivotSearch<T>::maxAbs(A, n, n);
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            const T* r = A[i];
+            for (int j = 0; j < n; j++) lu[(size_t)j * n + i] = r[j];
+        }
+
+        int info = 0;
+        int lda = n;
+        lapackGetrf(&n, &n, lu, &lda, ipiv, &info);
+
+        bool ok = (info == 0);
+        for (int i = 0; ok && i < n; i++) {
+            if (abs(lu[(size_t)i * n + i]) <= tolerance) ok = false;
+        }
+
+        factored = ok;
+        return ok;
+    }
+
+    // B is n x nrhs row-major on entry, solutions on return.
+    bool solveFactored(T* B, int nrhs) {
+        if (!factored) return false;
+
+        // getrs wants column-major right-hand sides.
+        T* cols = B;
+        if (nrhs > 1) {
+            cols = new T[(size_t)n * nrhs];
+            for (int i = 0; i < n; i++) {
+                for (int c = 0; c < nrhs; c++) cols[(size_t)c * n + i] = B[(size_t)i * nrhs + c];
+            }
+        }
+
+        char trans = 'N';
+        int info = 0, lda = n, ldb = n;
+        lapackGetrs(&trans, &n, &nrhs, lu, &lda, ipiv, cols, &ldb, &info);
+
+        if (nrhs > 1) {
+            for (int i = 0; i < n; i++) {
+                for (int c = 0; c < nrhs; c++) B[(size_t)i * nrhs + c] = cols[(size_t)c * n + i];
+            }
+            delete[] cols;
+        }
+
+        return info == 0;
+    }
+
+    // After factor(): overwrites A with U and b with L^-1 P b. Returns the
+    // sign of the row permutation.
+    int reduce(Matrix<T>& A, T* b) {
+        int rowSign = 1;
+        for (int i = 0; i < n; i++) {
+            int p = ipiv[i] - 1;
+            if (p != i) {
+                std::swap(b[i], b[p]);
+                rowSign = -rowSign;
+            }
+        }
+
+        for (int j = 0; j < n; j++) {
+            const T* l = lu + (size_t)j * n;
+            T bj = b[j];
+            for (int i = j + 1; i < n; i++) b[i] -= l[i] * bj;
+        }
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            T* r = A[i];
+            for (int j = 0; j < i; j++) r[j] = 0;
+            for (int j = i; j < n; j++) r[j] = lu[(size_t)j * n + i];
+        }
+        return rowSign;
+    }
+
+    bool solve(LinearSystem<T>* sys) {
+        int size = sys->getSize();
+        if (size <= 0 || sys->getEquationCount() != size) return false;
+
+        Matrix<T>& A = *sys->getMatrix();
+        Vector<T>& B = *sys->getConstants();
+        Vector<T>& X = *sys->getResult();
+
+        if (!factor(A, size)) return false;
+        for (int i = 0; i < size; i++) X[i] = B[i];
+        if (!solveFactored(&X[0], 1)) return false;
+
+        int rowSign = reduce(A, &B[0]);
+        sys->markReduced();
+        sys->recordDeterminant(rowSign);
+        return true;
+    }
+
+    // Overwrites A with the LU factors of A^T; solveFactored() cannot use
+    // them.
+    double determinant(Matrix<T>& A, int size) {
+        n = size;
+        delete[] ipiv;
+        ipiv = new int[n > 0 ? n : 1];
+        factored = false;
+        if (n <= 0) return 1.0;
+
+        bool copied;
+        T* data = storage(A, copied);
+        int info = 0, lda = n;
+        lapackGetrf(&n, &n, data, &lda, ipiv, &info);
+
+        double det = 1.0;
+        for (int i = 0; i < n; i++) {
+            det *= data[(size_t)i * n + i];
+            if (ipiv[i] != i + 1) det = -det;
+        }
+        release(A, data, copied);
+        return det;
+    }
+};
+
+#endif
+
+#endif
@@ -1,6 +1,13 @@
 #include "LinearSystem.h"
 #include "Command.h"
 #include "EquationGenerator.h"
+#include "SolverBackend.h"
+#include "SolverAutotuner.h"
+#include "BackendComparison.h"
+#include "TestSuite.h"
+#include "SparseSystem.h"
+#include "ConcurrentBenchmark.h"
+#include <thread>
 #include <omp.h> 
 #include <chrono>
 #include <vector>
@@ -9,41 +16,58 @@
 
 using namespace std;
 
-void runTest(int testNum, const string& desc, int vars, const vector<string>& equations) {
-    cout << "========================================\n";
-    cout << "Test " << testNum << ": " << desc << "\n";
-    cout << "========================================\n";
+// Headless entry used by CTest:
+//   LinearSolver --test [cases|solvers|fuzz|perf|all] [--baseline <file>]
+//       [--threshold <percent>] [--update-baseline] [--iterations <n>] [--seed <n>]
+// Returns 0 only when every check passes.
+int runTests(int argc, char** argv) {
+    string group = "all";
+    string baselinePath = "perf_baseline.txt";
+    double threshold = 50;
+    bool updateBaseline = false;
+    int iterations = 2000;
+    unsigned seed = 20240601;
 
-    LinearSystem<double> sys(vars);
-    bool valid = true;
-
-    for (const string& eq : equations) {
-        cout << "Input: " << eq << "\n";
-        if (!sys.addEquation(eq)) {
-            cout << "-> Failed to add equation.\n";
-            valid = false;
-        }
-    }
-
-    if (valid) {
-        if (sys.solve()) {
-            sys.printSolution();
-        }
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc) threshold = atof(argv[++i]);
+        else if (arg == "--update-baseline") updateBaseline = true;
+        else if (arg == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = (unsigned)atoi(argv[++i]);
+        else if (arg.rfind("--", 0) != 0) group = arg;
         else {
-            cout << "\n[Result] Singular matrix: No unique solution (Infinite or No Solution).\n\n";
+            cerr << "Unknown option: " << arg << endl;
+            return 2;
         }
     }
-    else {
-        cout << "\n[Result] System solving aborted due to invalid input.\n\n";
+
+    TestSuite suite;
+    bool all = (group == "all");
+    if (all || group == "cases") suite.runCases();
+    if (all || group == "solvers") suite.runSolvers();
+    if (all || group == "fuzz") suite.runParserFuzz(iterations, seed);
+    if (all || group == "perf") suite.runPerformance(baselinePath, threshold, updateBaseline);
+
+    if (suite.getPassed() + suite.getFailed() == 0) {
+        cerr << "Unknown test group: " << group << endl;
+        return 2;
     }
+    suite.printSummary();
+    return suite.getFailed() == 0 ? 0 : 1;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--test") return runTests(argc, argv);
+
     int mode;
     cout << "Select mode:\n"
         << " 1. Normal (user input + command interface)\n"
         << " 2. Benchmark (generation / timing)\n"
-        << " 3. Run Automated Tests (10 Cases)\n"
+        << " 3. Run Automated Tests (also: LinearSolver --test)\n"
+        << " 4. Compare Solver Backends (timing per N)\n"
+        << " 5. Sparse Multigrid (AMG on a generated Laplacian)\n"
+        << " 6. Concurrent Solves (throughput of independent systems)\n"
         << "Choice: ";
     cin >> mode;
     cin.ignore();
@@ -56,7 +80,28 @@ int main() {
         cout << "Enter number of variables (N): ";
         cin >> n;
 
-        LinearSystem<double> sys(n);
+        double capMB;
+        int pageChoice;
+        cout << "Memory cap in MB (0 = unlimited): ";
+        cin >> capMB;
+        cout << "Matrix pages (0 = default, 1 = transparent huge pages, 2 = explicit huge pages): ";
+        cin >> pageChoice;
+
+        size_t cap = (capMB > 0) ? (size_t)(capMB * 1024 * 1024) : 0;
+        size_t estimate = LinearSystem<double>::estimatePeakBytes(n, n);
+        cout << "Estimated peak memory: " << MemoryBudget::formatBytes(estimate) << endl;
+
+        if (cap > 0 && estimate > cap) {
+            cout << "The system does not fit in the " << MemoryBudget::formatBytes(cap) << " cap; aborting." << endl;
+            return 1;
+        }
+
+        PageMode pages = (pageChoice == 2) ? PageMode::Explicit
+            : (pageChoice == 1) ? PageMode::Transparent : PageMode::Default;
+
+        LinearSystem<double> sys(n, n, pages);
+        sys.setMemoryLimit(cap);
+        cout << "Matrix backing: " << pageModeName(sys.getPageMode()) << endl;
 
         cout << "\nChoose Input Method:\n";
         cout << "1. Manual Input\n";
@@ -65,15 +110,32 @@ int main() {
         cin >> choice;
         cin.ignore();
 
+        // Streamed equations are not kept; verification replays the
+        // generator from its seed instead.
+        unsigned seed = random_device{}();
+        if (choice != 2) sys.setVerification(true);
+
         if (choice == 2) {
-            EquationGenerator gen;
+            EquationGenerator gen(seed);
             cout << "Streaming " << n << " equations (Generate -> Add)..." << endl;
 
             auto start = std::chrono::high_resolution_clock::now();
 
+            // Generated in batches so parsing runs in parallel while memory
+            // for pending lines stays bounded.
+            const int batchSize = 4096;
+            vector<string> batch;
+            batch.reserve(batchSize);
             for (int i = 0; i < n; i++) {
-                string eq = gen.generateMixedEquation(n);
-                sys.addEquation(eq);
+                batch.push_back(gen.generateMixedEquation(n));
+                if ((int)batch.size() == batchSize || i == n - 1) {
+                    int added = sys.addEquations(batch);
+                    if (added != (int)batch.size()) {
+                        cout << "\n[Error] " << sys.getLastErrorMessage() << "\n";
+                        cout << (batch.size() - added) << " generated equations were rejected." << endl;
+                    }
+                    batch.clear();
+                }
             }
 
             auto end = std::chrono::high_resolution_clock::now();
@@ -91,11 +153,48 @@ int main() {
                     i++;
                 }
                 else {
+                    cout << "\n[Error] " << sys.getLastErrorMessage() << "\n";
                     cout << "Please try entering equation " << (i + 1) << " again.\n";
                 }
             }
         }
 
+        vector<shared_ptr<SolverBackend<double>>> backends = SolverRegistry<double>::all();
+        int backendChoice;
+        cout << "\nChoose Solver Backend:\n";
+        cout << "0. Auto (autotuned dispatch)\n";
+        for (size_t b = 0; b < backends.size(); b++) {
+            cout << (b + 1) << ". " << backends[b]->getName() << "\n";
+        }
+        cout << "Choice: ";
+        cin >> backendChoice;
+        cin.ignore();
+
+        shared_ptr<SolverBackend<double>> backend;
+        if (backendChoice >= 1 && backendChoice <= (int)backends.size()) {
+            backend = backends[backendChoice - 1];
+        }
+
+        if (backend && backend->getName() == "parallel") {
+            int pivotChoice;
+            cout << "\nChoose Pivoting Strategy:\n";
+            cout << "1. Partial (fastest)\n";
+            cout << "2. Rook\n";
+            cout << "3. Complete (most stable)\n";
+            cout << "Choice: ";
+            cin >> pivotChoice;
+            cin.ignore();
+
+            if (pivotChoice == 2) sys.setPivotStrategy(PivotStrategy::Rook);
+            else if (pivotChoice == 3) sys.setPivotStrategy(PivotStrategy::Complete);
+        }
+
+        SolverAutotuner<double> tuner;
+        if (!backend) {
+            cout << "Loading autotuning cache..." << endl;
+            if (tuner.ensureTuned()) cout << "First run: benchmarked backends and saved solver_tuning.cfg" << endl;
+        }
+
         cout << "-----------------------------------" << endl;
 #ifdef _OPENMP
         cout << "Parallel Mode: ON" << endl;
@@ -106,38 +205,241 @@ int main() {
         cout << "-----------------------------------" << endl;
 
         auto startSolve = std::chrono::high_resolution_clock::now();
-        bool success = sys.solve();
+        bool success;
+        string backendName;
+        if (backend) {
+            TuningParams params = { 64, 0, true };
+            success = backend->run(&sys, params);
+            backendName = backend->getName();
+        }
+        else {
+            success = tuner.solve(&sys);
+            backendName = tuner.getLastBackend();
+        }
         auto endSolve = std::chrono::high_resolution_clock::now();
 
         std::chrono::duration<double> diffSolve = endSolve - startSolve;
 
         if (success) {
-            cout << "System Solved in " << diffSolve.count() << " seconds." << endl;
-            if (n <= 100) sys.printSolution();
+            cout << "System Solved in " << diffSolve.count() << " seconds (backend: " << backendName << ")." << endl;
+            if (backendName == "parallel") {
+                cout << "Pivoting: " << pivotStrategyName(sys.getPivotStrategy())
+                    << ", Growth Factor: " << sys.getGrowthFactor() << endl;
+            }
+
+            string answer;
+            cout << "Verify residual and backward error (y/n): ";
+            getline(cin, answer);
+            if (answer == "y" || answer == "Y") {
+                auto startVerify = std::chrono::high_resolution_clock::now();
+                VerificationReport report;
+                if (sys.isVerifying()) {
+                    sys.verify();
+                    report = sys.getVerification();
+                }
+                else {
+                    EquationGenerator replay(seed);
+                    SolutionVerifier<double> verifier(&(*sys.getResult())[0], n, &sys.getSymbols());
+                    const int batchSize = 4096;
+                    vector<string> batch;
+                    batch.reserve(batchSize);
+                    for (int i = 0; i < n; i++) {
+                        batch.push_back(replay.generateMixedEquation(n));
+                        if ((int)batch.size() == batchSize || i == n - 1) {
+                            verifier.addEquations(batch);
+                            batch.clear();
+                        }
+                    }
+                    report = verifier.report();
+                }
+                auto endVerify = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> diffVerify = endVerify - startVerify;
+
+                cout << "Residual ||Ax - b||: " << report.residualMax << " (inf), " << report.residualTwo
+                    << " (2); backward error: " << report.backwardError
+                    << " (" << diffVerify.count() << " seconds)" << endl;
+            }
+            if (n <= 100) {
+                sys.printSolution();
+            }
+            else {
+                string path;
+                cout << "Write solution to file (leave empty to skip): ";
+                getline(cin, path);
+
+                if (!path.empty()) {
+                    size_t dot = path.rfind('.');
+                    SolutionFormat format = SolutionFormat::Text;
+                    if (dot != string::npos) parseSolutionFormat(path.substr(dot + 1), format);
+
+                    auto startWrite = std::chrono::high_resolution_clock::now();
+                    bool written = sys.exportSolution(path, format);
+                    auto endWrite = std::chrono::high_resolution_clock::now();
+                    std::chrono::duration<double> diffWrite = endWrite - startWrite;
+
+                    if (written) cout << "Solution written in " << diffWrite.count() << " seconds." << endl;
+                    else cout << "Could not write " << path << endl;
+                }
+            }
         }
         else {
             cout << "System could not be solved (Singular Matrix / No unique solution)." << endl;
         }
 
+        cout << "Peak RSS: " << MemoryBudget::formatBytes(MemoryBudget::peakResidentBytes())
+            << " (estimated " << MemoryBudget::formatBytes(estimate) << ")" << endl;
+
         cout << "\nPress Enter to exit...";
         cin.get();
         return 0;
     }
-    else if (mode == 3) {
-        cout << "\n--- Running Automated Test Suite ---\n\n";
+    else if (mode == 4) {
+        int maxN;
+        cout << "\n--- Solver Backend Comparison ---\n";
+        cout << "Largest N to benchmark: ";
+        cin >> maxN;
+        cin.ignore();
 
-        runTest(1, "Standard 2x2 System", 2, { "2x1 + 1x2 = 5", "-1x1 + 1x2 = 2" });
-        runTest(2, "Implicit Coefficients", 2, { "x1 + x2 = 5", "x1 - x2 = 1" });
-        runTest(3, "Unordered Variables", 2, { "4x2 + 3x1 = 10", "x1 - x2 = 1" });
-        runTest(4, "Missing Variables", 2, { "x1 = 5", "2x1 + 3x2 = 16" });
-        runTest(5, "Decimals and Negatives", 2, { "-0.5x1 + 1.5x2 = 3.5", "2.2x1 - 1.1x2 = 0" });
+        BackendComparison<double> comparison;
+        comparison.run(maxN);
 
-        runTest(6, "Inconsistent System (No Solution)", 2, { "x1 + x2 = 5", "x1 + x2 = 10" });
-        runTest(7, "Dependent System (Infinite Solutions)", 2, { "x1 + x2 = 5", "2x1 + 2x2 = 10" });
+        if (comparison.writeJson("benchmark_results.json")) {
+            cout << "Results written to benchmark_results.json" << endl;
+        }
+
+        cout << "\nPress Enter to exit...";
+        cin.get();
+        return 0;
+    }
+    else if (mode == 5) {
+        int grid;
+        int runChoice;
+        cout << "\n--- Sparse Algebraic Multigrid ---\n";
+        cout << "Grid size k (k*k unknowns, 5-point Laplacian): ";
+        cin >> grid;
+        cout << "1. Single configuration\n";
+        cout << "2. Benchmark every cycle / smoother / mode\n";
+        cout << "Choice: ";
+        cin >> runChoice;
+        cin.ignore();
+
+        SparseSystem<double> sys;
+        EquationGenerator gen;
+        int n = grid * grid;
+        cout << "Streaming " << n << " equations (Generate -> Add)..." << endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        const int batchSize = 4096;
+        vector<string> batch;
+        batch.reserve(batchSize);
+        for (int i = 0; i < n; i++) {
+            batch.push_back(gen.generateLaplacianEquation(i, grid));
+            if ((int)batch.size() == batchSize || i == n - 1) {
+                sys.addEquations(batch);
+                batch.clear();
+            }
+        }
+        bool assembled = sys.assemble();
+        if (!assembled) cout << "[Error] " << sys.getLastErrorMessage() << endl;
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> diff = end - start;
+        cout << "Generation, Parsing & Assembly Time: " << diff.count() << " seconds ("
+            << sys.getMatrix().getNonZeros() << " nonzeros)." << endl;
+
+        vector<AMGSolver<double>> configs;
+        if (runChoice == 2) {
+            for (AMGCycle c : { AMGCycle::V, AMGCycle::W }) {
+                for (AMGSmoother s : { AMGSmoother::Chebyshev, AMGSmoother::GaussSeidel }) {
+                    for (bool pcg : { false, true }) configs.emplace_back(c, s, pcg);
+                }
+            }
+        }
+        else {
+            int cycleChoice, smootherChoice, modeChoice;
+            cout << "Cycle (1 = V, 2 = W): ";
+            cin >> cycleChoice;
+            cout << "Smoother (1 = Chebyshev, 2 = multicolor Gauss-Seidel): ";
+            cin >> smootherChoice;
+            cout << "Use (1 = standalone multigrid, 2 = CG preconditioner): ";
+            cin >> modeChoice;
+            cin.ignore();
+            configs.emplace_back(cycleChoice == 2 ? AMGCycle::W : AMGCycle::V,
+                smootherChoice == 2 ? AMGSmoother::GaussSeidel : AMGSmoother::Chebyshev, modeChoice == 2);
+        }
+
+        if (assembled) {
+            cout << "-----------------------------------" << endl;
+            cout << left << setw(8) << "cycle" << setw(26) << "smoother" << setw(12) << "mode"
+                << setw(8) << "iters" << setw(14) << "setup (s)" << setw(14) << "solve (s)" << "rel. residual" << endl;
+            // Each configuration gets a fresh solver so only one hierarchy
+            // is alive at a time.
+            for (size_t c = 0; c < configs.size(); c++) {
+                AMGSolver<double> amg = configs[c];
+                bool converged = sys.solve(amg);
+                cout << left << setw(8) << amgCycleName(amg.getCycle()) << setw(26) << amgSmootherName(amg.getSmoother())
+                    << setw(12) << (amg.isPreconditioner() ? "pcg" : "standalone") << setw(8) << amg.getIterations()
+                    << setw(14) << amg.getSetupSeconds() << setw(14) << amg.getSolveSeconds()
+                    << amg.getRelativeResidual() << (converged ? "" : "  (not converged)") << endl;
+
+                if (c + 1 == configs.size()) {
+                    cout << "-----------------------------------" << endl;
+                    amg.printHierarchy();
+                }
+            }
+
+            if (n <= 100) {
+                sys.printSolution();
+            }
+            else {
+                string path;
+                cout << "Write solution to file (leave empty to skip): ";
+                getline(cin, path);
+
+                if (!path.empty()) {
+                    size_t dot = path.rfind('.');
+                    SolutionFormat format = SolutionFormat::Text;
+                    if (dot != string::npos) parseSolutionFormat(path.substr(dot + 1), format);
+                    if (!sys.exportSolution(path, format)) cout << "Could not write " << path << endl;
+                }
+            }
+        }
+
+        cout << "Peak RSS: " << MemoryBudget::formatBytes(MemoryBudget::peakResidentBytes()) << endl;
+
+        cout << "\nPress Enter to exit...";
+        cin.get();
+        return 0;
+    }
+    else if (mode == 6) {
+        int n, solves, workers;
+        cout << "\n--- Concurrent Independent Solves ---\n";
+        cout << "Variables per system (N): ";
+        cin >> n;
+        cout << "Solves per worker: ";
+        cin >> solves;
+        cout << "Largest worker count (0 = " << thread::hardware_concurrency() << " hardware threads): ";
+        cin >> workers;
+        cin.ignore();
+
+        if (workers <= 0) workers = max(1, (int)thread::hardware_concurrency());
+
+        ConcurrentBenchmark<double> benchmark;
+        if (benchmark.run(n, solves, workers) && benchmark.writeJson("concurrent_results.json")) {
+            cout << "Results written to concurrent_results.json" << endl;
+        }
+
+        cout << "\nPress Enter to exit...";
+        cin.get();
+        return 0;
+    }
+    else if (mode == 3) {
+        cout << "\n--- Running Automated Test Suite ---\n\n";
 
-        runTest(8, "Missing Equals Sign", 2, { "3x1 + 4x2 9", "x1 - x2 = 1" });
-        runTest(9, "Multiple Equals Signs", 2, { "3x1 + 4x2 == 9", "x1 - x2 = 1" });
-        runTest(10, "Invalid Characters", 2, { "3x1 + a*x2 = 9", "x1 - x2 = 1" });
+        TestSuite suite(true);
+        suite.runCases();
+        suite.runSolvers();
+        suite.runParserFuzz(2000, 20240601);
+        suite.printSummary();
 
         cout << "\nPress Enter to exit...";
         cin.get();
@@ -145,15 +447,21 @@ int main() {
     }
     else {
         int n;
+        int m;
         cout << "Enter number of variables: ";
         cin >> n;
+        cout << "Enter number of equations (0 = same as variables): ";
+        cin >> m;
         cin.ignore();
 
-        LinearSystem<double> sys(n);
+        if (m <= 0) m = n;
+
+        LinearSystem<double> sys(m, n);
+        sys.setVerification(true);
 
-        cout << "Enter " << n << " equations (e.g. 3x1 + 4x2 = 9):" << endl;
+        cout << "Enter " << m << " equations (e.g. 3x1 + 4x2 = 9):" << endl;
 
-        for (int i = 0; i < n; ) {
+        for (int i = 0; i < m; ) {
             string line;
             cout << "Eq " << (i + 1) << ": ";
             getline(cin, line);
@@ -162,6 +470,7 @@ int main() {
                 i++;
             }
             else {
+                cout << "\n[Error] " << sys.getLastErrorMessage() << "\n";
                 cout << "Please try entering equation " << (i + 1) << " again.\n\n";
             }
         }
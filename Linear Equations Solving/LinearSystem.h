@@ -4,132 +4,634 @@
 #include "Matrix.h"
 #include "Vector.h"
 #include "Equation.h" 
+#include "SymbolTable.h"
+#include "TriangularSolver.h"
+#include "Pivoting.h"
+#include "QRSolver.h"
+#include "SolutionWriter.h"
+#include "SolveControl.h"
+#include "SolutionVerifier.h"
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 using namespace std;
 
 const double EPSILON = 1e-9;
 
+// Why the last addEquation / addEquations / addConstantColumn call (or, for
+// SparseSystem, assembly) rejected its input; getLastErrorMessage() words it.
+enum class InputStatus {
+    Ok, ParseError, TooManyEquations, TooManyVariables, EquationsMissing,
+    AlreadyReduced, ConstantCount, NotSquare, ZeroDiagonal
+};
+
 template <typename T>
 class LinearSystem
 {
 private:
     int n;
+    int m;
     Matrix<T> A;
     Vector<T> B;
     Vector<T> result;
+    Vector<int> colPerm;
     int currentEqIndex;
+    PivotStrategy pivotStrategy;
+    double growthFactor;
+    int rank;
+    double residualNorm;
+    double determinant;
+    bool determinantKnown;
+    size_t memoryLimit;
+    T* rhsBlock;
+    int rhsColumns;
+    int rhsCapacity;
+    bool reduced;
+    SymbolTable symbols;
+    vector<int> outputOrder;
+    int orderedSymbols;
+    SolveControl* solveControl;
+    InputStatus lastError;
+    string lastErrorMessage;
+    bool keepEquations;
+    vector<string> equations;
+    VerificationReport verification;
+
+    bool fail(InputStatus status, string message) {
+        lastError = status;
+        lastErrorMessage = move(message);
+        return false;
+    }
+
+    // Maps the equation's names to columns, interning new ones. An equation
+    // that would need more columns than the system has is rolled back.
+    bool internTerms(Equation& eq, int* columns) {
+        Vector<Term>& terms = eq.getTerms();
+        int known = symbols.size();
+
+        for (int i = 0; i < terms.getSize(); i++) {
+            columns[i] = symbols.intern(eq.nameOf(terms[i]), terms[i].nameLength);
+        }
+
+        if (symbols.size() > n) {
+            symbols.truncate(known);
+            return fail(InputStatus::TooManyVariables, "Too many variables! The system has " + to_string(n) + ".");
+        }
+        return true;
+    }
+
+    void fillRow(int row, Equation& eq, const int* columns) {
+        B[row] = (T)eq.getConstant();
+        determinantKnown = false;
+
+        Vector<Term>& terms = eq.getTerms();
+        T* r = A[row];
+        for (int i = 0; i < terms.getSize(); i++) r[columns[i]] += (T)terms[i].value;
+    }
+
+    // Forward elimination of A together with nrhs right-hand sides stored
+    // row-major in rhs. Column swaps made by rook/complete pivoting are
+    // recorded in colPerm. Fails when the best available pivot is below
+    // EPSILON relative to the largest entry of A, or when the attached
+    // SolveControl stops it; rows reduced so far stay reduced, so the
+    // equations remain equivalent either way.
+    bool eliminate(T* rhs, int nrhs) {
+        for (int j = 0; j < n; j++) colPerm[j] = j;
+        growthFactor = 0;
+        determinant = 0;
+        determinantKnown = false;
+
+        double maxA = PivotSearch<T>::maxAbs(A, n, n);
+        if (maxA == 0) return false;
+        double tolerance = EPSILON * maxA;
+        double det = 1.0;
+
+        for (int i = 0; i < n; i++) {
+            if (solveControl && solveControl->checkpoint("elimination", i, n)) {
+                restoreColumnOrder();
+                if (i > 0) reduced = true;
+                return false;
+            }
+
+            PivotCandidate p = PivotSearch<T>::find(pivotStrategy, A, i, n);
+
+            if (p.value <= tolerance) {
+                restoreColumnOrder();
+                if (i > 0) reduced = true;
+                return false;
+            }
+
+            if (p.row != i) {
+                A.swapRows(i, p.row);
+                for (int c = 0; c < nrhs; c++) {
+                    std::swap(rhs[(size_t)i * nrhs + c], rhs[(size_t)p.row * nrhs + c]);
+                }
+                det = -det;
+            }
+            if (p.col != i) {
+                A.swapCols(i, p.col);
+                std::swap(colPerm[i], colPerm[p.col]);
+                det = -det;
+            }
+
+            T* pivotRowPtr = A[i];
+            T pivotDiag = pivotRowPtr[i];
+            det *= pivotDiag;
+            const T* pivotRhs = rhs + (size_t)i * nrhs;
+
+#pragma omp parallel for schedule(guided) 
+            for (int k = i + 1; k < n; k++) {
+
+                T* targetRowPtr = A[k];
+                T factor = targetRowPtr[i] / pivotDiag;
+
+                targetRowPtr[i] = 0;
+
+                for (int j = i + 1; j < n; j++) {
+                    targetRowPtr[j] -= factor * pivotRowPtr[j];
+                }
+
+                T* targetRhs = rhs + (size_t)k * nrhs;
+                for (int c = 0; c < nrhs; c++) targetRhs[c] -= factor * pivotRhs[c];
+            }
+        }
+
+        growthFactor = PivotSearch<T>::maxAbsUpper(A, n) / maxA;
+        determinant = det;
+        determinantKnown = true;
+        reduced = true;
+        return true;
+    }
+
+    // Undoes the column swaps of the last elimination so columns of A line
+    // up with variables again. x, when given, is permuted along with them,
+    // which turns a solution in pivot order into one in variable order
+    // without a scratch vector.
+    void restoreColumnOrder(T* x = nullptr, int nrhs = 1) {
+        for (int j = 0; j < n; j++) {
+            while (colPerm[j] != j) {
+                int target = colPerm[j];
+                A.swapCols(j, target);
+                if (x) {
+                    for (int c = 0; c < nrhs; c++) {
+                        std::swap(x[(size_t)j * nrhs + c], x[(size_t)target * nrhs + c]);
+                    }
+                }
+                std::swap(colPerm[j], colPerm[target]);
+            }
+        }
+    }
+
+    // One line with the last verify() result, if there is one.
+    void writeVerification(const char* label) {
+        if (verification.rows == 0) return;
+        char line[192];
+        snprintf(line, sizeof(line), "Residual ||Ax - b||%s: %.3e (inf), %.3e (2); backward error %.3e\n",
+            label, verification.residualMax, verification.residualTwo, verification.backwardError);
+        SolutionWriter<T>::writeStdoutText(line);
+    }
+
+    // Grows the row-major m x rhsCapacity block of constant columns,
+    // repacking rows to the new stride.
+    void growRhsBlock(int capacity) {
+        T* grown = new T[(size_t)m * capacity];
+        for (int i = 0; i < m; i++) {
+            for (int c = 0; c < rhsColumns; c++) {
+                grown[(size_t)i * capacity + c] = rhsBlock[(size_t)i * rhsCapacity + c];
+            }
+        }
+        delete[] rhsBlock;
+        rhsBlock = grown;
+        rhsCapacity = capacity;
+    }
 
 public:
-    LinearSystem(int size)
-        : n(size),
+    LinearSystem(int size) : LinearSystem(size, size) {}
+
+    LinearSystem(int equations, int variables, PageMode pages = PageMode::Default)
+        : n(variables),
+        m(equations),
         currentEqIndex(0),
-        A(size, size),    
-        B(size),          
-        result(size)     
+        A(equations, variables, pages),
+        B(equations),
+        result(variables),
+        colPerm(variables),
+        pivotStrategy(PivotStrategy::Partial),
+        growthFactor(0),
+        rank(0),
+        residualNorm(0),
+        determinant(0),
+        determinantKnown(false),
+        memoryLimit(0),
+        rhsBlock(nullptr),
+        rhsColumns(0),
+        rhsCapacity(0),
+        reduced(false),
+        orderedSymbols(-1),
+        solveControl(nullptr),
+        lastError(InputStatus::Ok),
+        keepEquations(false),
+        verification()
     {
     }
 
+    // Upper bound on what a system of this shape holds at its peak: A, the
+    // row table, B, result and the pivot bookkeeping, plus the larger of the
+    // scratch needed by solve() and by solveLeastSquares(). Nothing is
+    // allocated, so callers can check it against a budget first.
+    static size_t estimatePeakBytes(int equations, int variables) {
+        size_t m = (size_t)(equations > 0 ? equations : 0);
+        size_t n = (size_t)(variables > 0 ? variables : 0);
+
+        size_t resident = m * n * sizeof(T) + m * sizeof(T*)
+            + m * sizeof(T) + n * sizeof(T) + n * sizeof(int);
+
+        size_t solveScratch = n * sizeof(T*);
+        size_t leastSquaresScratch = m * sizeof(T*) + n * sizeof(int)
+            + 2 * n * sizeof(double) + 3 * n * sizeof(T);
+
+        return resident + (solveScratch > leastSquaresScratch ? solveScratch : leastSquaresScratch);
+    }
+
+    size_t estimatePeakBytes() const { return estimatePeakBytes(m, n); }
+
+    // 0 means unlimited. Operations that would need a transient copy of A
+    // check this and switch to an in-place variant when the copy won't fit.
+    void setMemoryLimit(size_t bytes) { memoryLimit = bytes; }
+    size_t getMemoryLimit() const { return memoryLimit; }
+
+    bool fitsMemoryLimit(size_t extraBytes) const {
+        return memoryLimit == 0 || estimatePeakBytes() + extraBytes <= memoryLimit;
+    }
+
+    PageMode getPageMode() const { return A.getPageMode(); }
+
     ~LinearSystem() {
+        delete[] rhsBlock;
     }
 
 
+    // Nothing here prints; a rejected equation leaves the reason in
+    // getLastError() / getLastErrorMessage().
     bool addEquation(const string& input) {
-        if (currentEqIndex >= n) {
-            cerr << "Error: Too many equations added!" << endl;
-            return false;
-        }
+        if (currentEqIndex >= m) return fail(InputStatus::TooManyEquations, "Too many equations added!");
 
         Equation eq;
+        if (eq.parse(input) != ParseStatus::Ok) return fail(InputStatus::ParseError, eq.errorMessage());
+
+        vector<int> columns(eq.getTerms().getSize());
+        if (!internTerms(eq, columns.data())) return false;
+
+        fillRow(currentEqIndex, eq, columns.data());
+        if (keepEquations) equations.push_back(input);
+
+        currentEqIndex++;
+        return true;
+    }
 
-        if (!eq.parse(input)) {
-            return false;
+    // Same as calling addEquation on each line, but the lines are parsed in
+    // parallel. Names are then interned in input order so column ids don't
+    // depend on the thread count, and the rows are filled in parallel.
+    // Returns how many equations were added; the last rejected line sets
+    // the error.
+    int addEquations(const vector<string>& lines) {
+        int count = (int)lines.size();
+        if (currentEqIndex + count > m) {
+            fail(InputStatus::TooManyEquations, "Too many equations added!");
+            return 0;
         }
 
-        B[currentEqIndex] = (T)eq.getConstant();
+        vector<Equation> parsed(count);
+        vector<char> ok(count);
 
-        Vector<Term>& terms = eq.getTerms();
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < count; i++) ok[i] = parsed[i].parse(lines[i]) == ParseStatus::Ok;
 
-        for (int i = 0; i < terms.getSize(); i++) {
-            Term t = terms[i];
-            int colIndex = t.index - 1;
+        vector<size_t> first(count + 1, 0);
+        for (int i = 0; i < count; i++) first[i + 1] = first[i] + parsed[i].getTerms().getSize();
+        vector<int> columns(first[count]);
+        vector<int> rows(count, -1);
 
-            if (colIndex >= 0 && colIndex < n) {
-                A[currentEqIndex][colIndex] += (T)t.value;
+        int added = 0;
+        for (int i = 0; i < count; i++) {
+            if (!ok[i]) {
+                fail(InputStatus::ParseError, "Line " + to_string(i + 1) + ": " + parsed[i].errorMessage());
+                continue;
             }
+            if (!internTerms(parsed[i], &columns[first[i]])) continue;
+            rows[i] = currentEqIndex + added++;
+            if (keepEquations) equations.push_back(lines[i]);
         }
 
-        currentEqIndex++;
-        return true;
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < count; i++) {
+            if (rows[i] >= 0) fillRow(rows[i], parsed[i], &columns[first[i]]);
+        }
+
+        currentEqIndex += added;
+        return added;
     }
 
-    bool solve() {
-        double* bPtr = &B[0];
+    InputStatus getLastError() const { return lastError; }
+    const string& getLastErrorMessage() const { return lastErrorMessage; }
 
+    // Column of a named variable, -1 if it never appeared.
+    int findVariable(const string& name) const { return symbols.find(name); }
 
-        for (int i = 0; i < n; i++) {
+    // Columns no equation has named yet print as ?<column>.
+    string variableName(int col) const {
+        if (col < symbols.size()) return symbols.name(col);
+        return "?" + to_string(col + 1);
+    }
 
-            int pivotRow = i;
-            double maxVal = abs(A[i][i]);
+    const SymbolTable& getSymbols() const { return symbols; }
 
-            for (int k = i + 1; k < n; k++) {
-                double val = abs(A[k][i]);
-                if (val > maxVal) {
-                    maxVal = val;
-                    pivotRow = k;
-                }
-            }
+    // Columns in natural name order, the order solutions are printed in.
+    const vector<int>& getVariableOrder() {
+        if (orderedSymbols != symbols.size()) {
+            outputOrder = symbols.naturalOrder();
+            for (int col = symbols.size(); col < n; col++) outputOrder.push_back(col);
+            orderedSymbols = symbols.size();
+        }
+        return outputOrder;
+    }
 
-            if (pivotRow != i) {
-                A.swapRows(i, pivotRow);
-                std::swap(bPtr[i], bPtr[pivotRow]);
+    // Sign of the permutation from column order to name order; multiplies a
+    // determinant of A into the determinant of the matrix as users read it.
+    int variableOrderSign() {
+        const vector<int>& order = getVariableOrder();
+        vector<char> seen(n, 0);
+        int sign = 1;
+        for (int start = 0; start < n; start++) {
+            if (seen[start]) continue;
+            int length = 0;
+            for (int j = start; !seen[j]; j = order[j]) {
+                seen[j] = 1;
+                length++;
             }
+            if (length % 2 == 0) sign = -sign;
+        }
+        return sign;
+    }
 
-            if (abs(A[i][i]) < EPSILON) return false;
+    bool solve() {
+        if (m != n) return false;
 
-            double* pivotRowPtr = A[i];
-            double pivotDiag = pivotRowPtr[i];
+        T* bPtr = &B[0];
+        verification = VerificationReport();
 
-#pragma omp parallel for schedule(guided) 
-            for (int k = i + 1; k < n; k++) {
+        if (!eliminate(bPtr, 1)) return false;
 
-                double* targetRowPtr = A[k];
-                double factor = targetRowPtr[i] / pivotDiag;
+        T* x = &result[0];
+        for (int i = 0; i < n; i++) x[i] = bPtr[i];
 
-                targetRowPtr[i] = 0;
+        TriangularSolver<T>().solveUpper(A, x, n);
 
-                for (int j = i + 1; j < n; j++) {
-                    targetRowPtr[j] -= factor * pivotRowPtr[j];
-                }
+        restoreColumnOrder(x);
+        rank = n;
+        residualNorm = 0;
+        return true;
+    }
+
+    // Least-squares / minimum-norm solve for any m x n system, including
+    // singular and rectangular ones. A and B are left as Q^T A and Q^T B:
+    // the same equations in upper trapezoidal form, in the original column
+    // order. Returns false only when every coefficient is zero.
+    bool solveLeastSquares() {
+        verification = VerificationReport();
+        reduced = true;
+        QRSolver<T> qr;
+        rank = qr.solve(A, &B[0], m, n, &result[0], EPSILON);
+        determinant = qr.getDeterminant();
+        determinantKnown = (m == n);
+        residualNorm = qr.getResidualNorm();
+        growthFactor = 0;
+        return rank > 0;
+    }
+
+    // Determinant of A computed by reducing the system in place: A and B go
+    // through the same pivoted elimination as solve(), so the equations
+    // stay equivalent, only in upper-triangular form. Costs no n x n copy.
+    double reduceForDeterminant() {
+        if (m != n) return 0;
+        if (!eliminate(&B[0], 1)) return 0;
+        restoreColumnOrder();
+        return determinant;
+    }
+
+    // Determinant from the last successful factorization (any backend's
+    // solve or reduceForDeterminant()), signed for the swaps it made. Only
+    // meaningful while hasDeterminant() is true: once A holds a factor, the
+    // product of its diagonal has lost the sign of the row swaps.
+    double getLastDeterminant() const { return determinant; }
+    bool hasDeterminant() const { return determinantKnown; }
+
+    // For backends that factor A in place without column swaps: call once
+    // the diagonal of A holds U, with the parity of the row swaps made.
+    void recordDeterminant(int rowSign) {
+        double det = rowSign;
+        for (int i = 0; i < n; i++) det *= A[i][i];
+        determinant = det;
+        determinantKnown = true;
+    }
 
-                bPtr[k] -= factor * bPtr[i];
+    // Numerical rank found by the last solve; below getSize() means the
+    // least-squares result is the minimum-norm one.
+    int getRank() const { return rank; }
+    double getResidualNorm() const { return residualNorm; }
+
+    // Appends one more column of constants (m numbers separated by spaces
+    // or commas) for the coefficients already loaded. Column 0 of the block
+    // is always B, so the equations' own constants are solved alongside.
+    bool addConstantColumn(const string& line) {
+        if (currentEqIndex < m) {
+            return fail(InputStatus::EquationsMissing, "Add all equations before extra constant columns.");
+        }
+        if (reduced) {
+            return fail(InputStatus::AlreadyReduced, "The system is already reduced; stream constant columns before solving or combining equations.");
+        }
+
+        T* values = new T[m > 0 ? m : 1];
+        int count = 0;
+        const char* p = line.c_str();
+        while (*p) {
+            if (*p == ' ' || *p == ',' || *p == '\t') {
+                p++;
+                continue;
+            }
+            char* end;
+            double v = strtod(p, &end);
+            if (end == p || count >= m) {
+                count = -1;
+                break;
             }
+            values[count++] = (T)v;
+            p = end;
+        }
+
+        if (count != m) {
+            delete[] values;
+            return fail(InputStatus::ConstantCount, "Expected " + to_string(m) + " constants in the column.");
         }
 
-        for (int i = n - 1; i >= 0; i--) {
-            double sum = 0;
-            double* rowPtr = A[i];
-            for (int j = i + 1; j < n; j++) sum += rowPtr[j] * result[j];
-            result[i] = (bPtr[i] - sum) / A[i][i];
+        if (rhsColumns == 0) {
+            growRhsBlock(4);
+            for (int i = 0; i < m; i++) rhsBlock[(size_t)i * rhsCapacity] = B[i];
+            rhsColumns = 1;
         }
+        if (rhsColumns == rhsCapacity) growRhsBlock(rhsCapacity * 2);
 
+        for (int i = 0; i < m; i++) rhsBlock[(size_t)i * rhsCapacity + rhsColumns] = values[i];
+        rhsColumns++;
+
+        delete[] values;
+        return true;
+    }
+
+    // Number of right-hand sides solveAll() works on, B included.
+    int getConstantColumnCount() const { return rhsColumns > 0 ? rhsColumns : 1; }
+
+    // Row-major m x getConstantColumnCount() block once a second column has
+    // been added, nullptr before; after solveAll() it holds the solutions.
+    const T* getConstantBlock() const { return rhsBlock; }
+
+    // One factorization of A shared by every constant column, then a batched
+    // triangular solve. Afterwards the block holds one solution per column,
+    // B holds the reduced first column and result the first solution, the
+    // same state solve() leaves behind.
+    bool solveAll() {
+        if (m != n) return false;
+        if (rhsColumns == 0) return solve();
+        verification = VerificationReport();
+
+        if (rhsCapacity != rhsColumns) growRhsBlock(rhsColumns);
+        for (int i = 0; i < m; i++) rhsBlock[(size_t)i * rhsColumns] = B[i];
+
+        if (!eliminate(rhsBlock, rhsColumns)) return false;
+
+        for (int i = 0; i < n; i++) B[i] = rhsBlock[(size_t)i * rhsColumns];
+
+        TriangularSolver<T>().solveUpperMulti(A, rhsBlock, n, rhsColumns);
+        restoreColumnOrder(rhsBlock, rhsColumns);
+
+        for (int i = 0; i < n; i++) result[i] = rhsBlock[(size_t)i * rhsColumns];
+
+        rank = n;
+        residualNorm = 0;
         return true;
     }
 
+    // With verification on, accepted equations are also kept as entered
+    // (their text, not a dense row) so verify() can measure the solution
+    // against the system as written after elimination has overwritten A.
+    // Turn it on before adding equations.
+    void setVerification(bool on) {
+        keepEquations = on;
+        if (!on) vector<string>().swap(equations);
+    }
+    bool isVerifying() const { return keepEquations; }
+
+    // Residual and normwise backward error of result (the first constants
+    // column) against the kept equations; printSolution() shows them until
+    // the next solve. False when no equations were kept.
+    bool verify() {
+        if (equations.empty()) return false;
+        SolutionVerifier<T> verifier(&result[0], n, &symbols);
+        verifier.addEquations(equations);
+        verification = verifier.report();
+        return verification.rows > 0;
+    }
+
+    const VerificationReport& getVerification() const { return verification; }
+
+    void printAllSolutions() {
+        if (rhsColumns == 0) {
+            printSolution();
+            return;
+        }
+
+        for (int c = 0; c < rhsColumns; c++) {
+            string header = "\n--- Solution (constants column " + to_string(c + 1) + ") ---\n";
+            SolutionWriter<T>::writeStdoutText(header.c_str());
+            SolutionWriter<T>::writeStdout(rhsBlock + c, n, SolutionFormat::Text, 6, rhsColumns,
+                &symbols, getVariableOrder().data());
+        }
+        writeVerification(" (constants column 1)");
+        SolutionWriter<T>::writeStdoutText("----------------\n\n");
+    }
+
+    // Every path that overwrites A calls this (or clearMultipliers), after
+    // which addConstantColumn refuses columns for the coefficients as they
+    // were entered and the determinant is unknown until recorded again.
+    void markReduced() {
+        reduced = true;
+        determinantKnown = false;
+    }
+
+    // Row operation target += factor * source on A, B and every streamed
+    // constant column, so the equations stay equivalent. Adding another row
+    // keeps the determinant; combining a row with itself scales it by
+    // 1 + factor.
+    void combineRows(int target, int source, T factor) {
+        if (target == source) determinant *= 1 + (double)factor;
+
+        T* t = A[target];
+        const T* s = A[source];
+        for (int j = 0; j < n; j++) t[j] += factor * s[j];
+        B[target] += factor * B[source];
+        for (int c = 1; c < rhsColumns; c++) {
+            rhsBlock[(size_t)target * rhsCapacity + c] += factor * rhsBlock[(size_t)source * rhsCapacity + c];
+        }
+        reduced = true;
+    }
+
+    // For solvers that factor A in place and store L below the diagonal:
+    // zeroes the multipliers of the first 'columns' columns, which leaves the
+    // rows reduced but equivalent to the equations as entered.
+    void clearMultipliers(int columns) {
+#pragma omp parallel for schedule(static)
+        for (int i = 1; i < m; i++) {
+            T* r = A[i];
+            int end = min(i, columns);
+            for (int j = 0; j < end; j++) r[j] = 0;
+        }
+        if (columns > 0) markReduced();
+    }
+
+    // Solvers working on this system check the control between steps for
+    // cancellation and deadlines and report progress through it. nullptr
+    // (the default) runs every solve to completion.
+    void setSolveControl(SolveControl* control) { solveControl = control; }
+    SolveControl* getSolveControl() const { return solveControl; }
+
+    void setPivotStrategy(PivotStrategy strategy) { pivotStrategy = strategy; }
+    PivotStrategy getPivotStrategy() const { return pivotStrategy; }
+
+    // max|U| / max|A| from the last elimination; large values mean the
+    // chosen pivots let entries grow and the result may be inaccurate.
+    double getGrowthFactor() const { return growthFactor; }
+
     Matrix<T>* getMatrix() { return &A; }
     Vector<T>* getConstants() { return &B; }
     Vector<T>* getResult() { return &result; }
 
     int getSize() const { return n; }
+    int getEquationCount() const { return m; }
 
     void printSolution() {
-        cout << "\n--- Solution ---" << endl;
-        for (int i = 0; i < n; i++) {
-            cout << "x" << (i + 1) << " = " << result[i] << endl;
-        }
-        cout << "----------------\n" << endl;
+        SolutionWriter<T>::writeStdoutText("\n--- Solution ---\n");
+        SolutionWriter<T>::writeStdout(&result[0], n, SolutionFormat::Text, 6, 1,
+            &symbols, getVariableOrder().data());
+        writeVerification("");
+        SolutionWriter<T>::writeStdoutText("----------------\n\n");
+    }
+
+    bool exportSolution(const string& path, SolutionFormat format) {
+        return SolutionWriter<T>::writeFile(path, &result[0], n, format, 0,
+            &symbols, getVariableOrder().data());
     }
 };
 
@@ -4,8 +4,11 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdlib>
+#include <cassert>
 #include <string>
+#include <type_traits>
 #include <omp.h>
+#include "MemoryBudget.h"
 using namespace std;
 
 template <typename T>
@@ -16,18 +19,30 @@ private:
     T** rowPtrs;    
     int rows;
     int cols;
+    PageMode pageMode;
 
 public:
 
-    Matrix(int r, int c) {
+    Matrix(int r, int c, PageMode pages = PageMode::Default) {
         rows = r;
         cols = c;
-        flatData = new T[rows * cols];
+        pageMode = PageMode::Default;
+
+        if (is_trivially_copyable<T>::value) {
+            flatData = (T*)MemoryBudget::allocate(storageBytes(), pages, pageMode);
+        }
+        else {
+            flatData = nullptr;
+        }
+        if (!flatData) {
+            pageMode = PageMode::Default;
+            flatData = new T[(size_t)rows * cols];
+        }
         rowPtrs = new T * [rows];
 
 #pragma omp parallel for schedule(static)
         for (int i = 0; i < rows; i++) {
-            rowPtrs[i] = &flatData[i * cols];
+            rowPtrs[i] = &flatData[(size_t)i * cols];
             for (int j = 0; j < cols; j++) {
                 rowPtrs[i][j] = T(); 
             }
@@ -36,11 +51,15 @@ public:
 
     ~Matrix() {
         delete[] rowPtrs;
-        delete[] flatData;
+        if (pageMode == PageMode::Default) delete[] flatData;
+        else MemoryBudget::release(flatData, storageBytes(), pageMode);
     }
 
+    size_t storageBytes() const { return (size_t)rows * cols * sizeof(T); }
+    PageMode getPageMode() const { return pageMode; }
+
     T* operator[](int index) {
-        if (index < 0 || index >= rows) exit(1);
+        assert(index >= 0 && index < rows && "Matrix row out of bounds");
         return rowPtrs[index];
     }
 
@@ -53,17 +72,28 @@ public:
         rowPtrs[r2] = temp;
     }
 
-    int getTermSortID(string term) {
-        if (term.empty() || term == "0") return 99999; 
-        size_t xPos = term.find('x');
-        if (xPos == string::npos) return 99999; 
-        try {
-            return stoi(term.substr(xPos + 1));
+    void swapCols(int c1, int c2) {
+        if (c1 == c2) return;
+
+#pragma omp parallel for schedule(static) if (rows > 512)
+        for (int i = 0; i < rows; i++) {
+            T temp = rowPtrs[i][c1];
+            rowPtrs[i][c1] = rowPtrs[i][c2];
+            rowPtrs[i][c2] = temp;
         }
-        catch (...) { return 99999; }
     }
 
+    // Start of the row-major storage when no row swaps are outstanding,
+    // nullptr otherwise; lets external kernels work on A without a copy.
+    T* contiguousData() {
+        for (int i = 0; i < rows; i++) {
+            if (rowPtrs[i] != flatData + (size_t)i * cols) return nullptr;
+        }
+        return flatData;
+    }
 
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
 
     void print() const {
         for (int i = 0; i < rows; i++) {
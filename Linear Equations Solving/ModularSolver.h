@@ -0,0 +1,330 @@
+#ifndef MODULARSOLVER_H_
+#define MODULARSOLVER_H_
+
+#include "LinearSystem.h"
+#include "BigInteger.h"
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <omp.h>
+
+using namespace std;
+
+enum class ExactStatus { Solved, NotSquare, NotRational, Singular, NoConvergence };
+
+inline const char* exactStatusMessage(ExactStatus status) {
+    switch (status) {
+    case ExactStatus::Solved: return "solved exactly";
+    case ExactStatus::NotSquare: return "exact solving needs a square system";
+    case ExactStatus::NotRational: return "coefficients are not exact decimals of at most 9 places and 14 digits";
+    case ExactStatus::Singular: return "the system is singular";
+    default: return "reconstruction did not converge";
+    }
+}
+
+// Arithmetic modulo an odd p < 2^31 in Montgomery form with R = 2^32.
+// Every operation is branch-free so the row updates vectorize.
+struct MontgomeryField
+{
+    uint32_t p;
+    uint32_t pInv;
+    uint32_t r2;
+
+    explicit MontgomeryField(uint32_t prime) : p(prime) {
+        uint32_t inv = prime;
+        for (int i = 0; i < 4; i++) inv *= 2 - prime * inv;
+        pInv = 0u - inv;
+        uint64_t r = ((uint64_t)1 << 32) % prime;
+        r2 = (uint32_t)(r * r % prime);
+    }
+
+    uint32_t reduce(uint64_t t) const {
+        uint32_t m = (uint32_t)t * pInv;
+        uint32_t u = (uint32_t)((t + (uint64_t)m * p) >> 32);
+        return u >= p ? u - p : u;
+    }
+
+    uint32_t mul(uint32_t a, uint32_t b) const { return reduce((uint64_t)a * b); }
+    uint32_t add(uint32_t a, uint32_t b) const { uint32_t s = a + b; return s >= p ? s - p : s; }
+    uint32_t sub(uint32_t a, uint32_t b) const { return a >= b ? a - b : a + p - b; }
+    uint32_t toMont(uint32_t a) const { return mul(a, r2); }
+    uint32_t fromMont(uint32_t a) const { return reduce(a); }
+
+    uint32_t inverse(uint32_t a) const {
+        uint32_t result = toMont(1);
+        uint32_t e = p - 2;
+        while (e) {
+            if (e & 1) result = mul(result, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return result;
+    }
+};
+
+// Exact rational solution of a square system. Rows are scaled to integers
+// (decimal inputs by a power of ten), then eliminated modulo several
+// 31-bit primes in parallel. The residues are combined with the Chinese
+// remainder theorem and every component is rebuilt as a fraction by rational
+// reconstruction. Rounds of primes continue until two consecutive rounds
+// rebuild the same solution, or the modulus passes the Hadamard bound on
+// Cramer's rule numerators, after which the answer is certain.
+template <typename T>
+class ModularSolver
+{
+private:
+    static const int MAX_DECIMALS = 9;
+
+    // Largest scaled magnitude whose rounding error bound stays below 1/4.
+    static constexpr double INTEGER_LIMIT = 0.25 / (8 * numeric_limits<double>::epsilon());
+    static const int SINGULAR_PRIMES = 3;
+
+    vector<uint32_t> primes;
+    vector<BigInteger> numerators;
+    vector<BigInteger> denominators;
+    int primesUsed;
+    int skippedPrimes;
+
+    uint32_t prime(size_t index) {
+        while (primes.size() <= index) {
+            uint32_t c = primes.empty() ? 2147483647u : primes.back() - 2;
+            for (;; c -= 2) {
+                bool isPrime = true;
+                for (uint32_t d = 3; d * d <= c; d += 2) {
+                    if (c % d == 0) {
+                        isPrime = false;
+                        break;
+                    }
+                }
+                if (isPrime) break;
+            }
+            primes.push_back(c);
+        }
+        return primes[index];
+    }
+
+    // Scales every row of [A | B] by the smallest power of ten that makes
+    // it integral. A scaled value counts as an integer only when it is
+    // within a few rounding errors (parse plus one multiply) of one. Past
+    // INTEGER_LIMIT that bound nears 1/2, where a fraction could pass for an
+    // integer, so such rows fail instead of being rounded.
+    static bool toIntegers(LinearSystem<T>* sys, vector<int64_t>& out, double& log2Bound) {
+        Matrix<T>& A = *sys->getMatrix();
+        Vector<T>& B = *sys->getConstants();
+        int n = sys->getSize();
+        int w = n + 1;
+        out.assign((size_t)n * w, 0);
+        log2Bound = 0;
+        bool ok = true;
+
+#pragma omp parallel for schedule(static) reduction(&&:ok) reduction(+:log2Bound)
+        for (int i = 0; i < n; i++) {
+            int64_t* row = &out[(size_t)i * w];
+            bool rowOk = false;
+            double scale = 1;
+
+            for (int k = 0; k <= MAX_DECIMALS && !rowOk; k++, scale *= 10) {
+                rowOk = true;
+                for (int j = 0; j < w && rowOk; j++) {
+                    double v = (double)(j < n ? A[i][j] : B[i]) * scale;
+                    double r = nearbyint(v);
+                    if (fabs(v) >= INTEGER_LIMIT || fabs(v - r) > 8 * numeric_limits<double>::epsilon() * fabs(v)) rowOk = false;
+                    else row[j] = (int64_t)r;
+                }
+            }
+
+            double norm2 = 0;
+            for (int j = 0; j < w; j++) norm2 += (double)row[j] * (double)row[j];
+            if (norm2 > 0) log2Bound += 0.5 * log2(norm2);
+            ok = ok && rowOk;
+        }
+        return ok;
+    }
+
+    // Gaussian elimination of the integer system modulo one prime. Returns
+    // false when the matrix is singular modulo p.
+    static bool solveModP(const vector<int64_t>& system, int n, uint32_t p, uint32_t* x) {
+        MontgomeryField F(p);
+        int w = n + 1;
+        vector<uint32_t> a((size_t)n * w);
+
+        for (size_t k = 0; k < a.size(); k++) {
+            int64_t r = system[k] % (int64_t)p;
+            a[k] = F.toMont((uint32_t)(r < 0 ? r + p : r));
+        }
+
+        for (int k = 0; k < n; k++) {
+            int pivot = k;
+            while (pivot < n && a[(size_t)pivot * w + k] == 0) pivot++;
+            if (pivot == n) return false;
+            if (pivot != k) {
+                swap_ranges(a.begin() + (size_t)k * w, a.begin() + (size_t)(k + 1) * w, a.begin() + (size_t)pivot * w);
+            }
+
+            uint32_t* pr = &a[(size_t)k * w];
+            uint32_t inv = F.inverse(pr[k]);
+#pragma omp simd
+            for (int j = k; j < w; j++) pr[j] = F.mul(pr[j], inv);
+
+            for (int i = k + 1; i < n; i++) {
+                uint32_t* r = &a[(size_t)i * w];
+                uint32_t f = r[k];
+                if (f == 0) continue;
+#pragma omp simd
+                for (int j = k; j < w; j++) r[j] = F.sub(r[j], F.mul(f, pr[j]));
+            }
+        }
+
+        for (int i = n - 1; i >= 0; i--) {
+            const uint32_t* r = &a[(size_t)i * w];
+            uint32_t s = r[n];
+            for (int j = i + 1; j < n; j++) s = F.sub(s, F.mul(r[j], x[j]));
+            x[i] = s;
+        }
+        for (int i = 0; i < n; i++) x[i] = F.fromMont(x[i]);
+        return true;
+    }
+
+    static uint32_t inverseModP(uint32_t a, uint32_t p) {
+        uint64_t result = 1, base = a % p;
+        for (uint32_t e = p - 2; e; e >>= 1) {
+            if (e & 1) result = result * base % p;
+            base = base * base % p;
+        }
+        return (uint32_t)result;
+    }
+
+    // Wang's rational reconstruction: the fraction num/den with
+    // |num|, den <= bound and num = den * a (mod M), if there is one.
+    static bool reconstruct(const BigInteger& a, const BigInteger& M, const BigInteger& bound,
+        BigInteger& num, BigInteger& den) {
+        BigInteger r0 = M, r1 = a, t0 = 0, t1 = 1;
+        while (r1 > bound) {
+            BigInteger q, r;
+            BigInteger::divMod(r0, r1, q, r);
+            r0 = r1;
+            r1 = r;
+            BigInteger t = t0 - q * t1;
+            t0 = t1;
+            t1 = t;
+        }
+        if (t1.isZero() || t1.abs() > bound) return false;
+        if (t1.isNegative()) {
+            r1 = -r1;
+            t1 = -t1;
+        }
+        if (BigInteger::gcd(r1, t1) != BigInteger(1)) return false;
+        num = r1;
+        den = t1;
+        return true;
+    }
+
+public:
+    ModularSolver() : primesUsed(0), skippedPrimes(0) {}
+
+    ExactStatus solve(LinearSystem<T>* sys) {
+        numerators.clear();
+        denominators.clear();
+        primesUsed = 0;
+        skippedPrimes = 0;
+
+        int n = sys->getSize();
+        if (sys->getEquationCount() != n || n == 0) return ExactStatus::NotSquare;
+
+        vector<int64_t> system;
+        double log2Bound;
+        if (!toIntegers(sys, system, log2Bound)) return ExactStatus::NotRational;
+
+        // Past 2 * H^2 reconstruction is guaranteed; every prime adds > 30 bits.
+        int certainPrimes = (int)ceil((2 * log2Bound + 2) / 30.0) + 1;
+
+        int batch = 2;
+#ifdef _OPENMP
+        batch = max(batch, omp_get_max_threads());
+#endif
+
+        vector<BigInteger> residues(n);
+        BigInteger M = 1;
+        vector<BigInteger> lastNum, lastDen;
+        size_t nextPrime = 0;
+        int goodPrimes = 0;
+
+        while (goodPrimes < certainPrimes + SINGULAR_PRIMES) {
+            vector<uint32_t> ps(batch);
+            for (int b = 0; b < batch; b++) ps[b] = prime(nextPrime++);
+
+            vector<vector<uint32_t>> solutions(batch, vector<uint32_t>(n));
+            vector<char> solved(batch);
+
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int b = 0; b < batch; b++) {
+                solved[b] = solveModP(system, n, ps[b], solutions[b].data());
+            }
+
+            for (int b = 0; b < batch; b++) {
+                if (!solved[b]) {
+                    skippedPrimes++;
+                    continue;
+                }
+                uint32_t p = ps[b];
+                uint32_t inv = inverseModP(M.mod(p), p);
+
+#pragma omp parallel for schedule(static)
+                for (int i = 0; i < n; i++) {
+                    uint64_t diff = (uint64_t)solutions[b][i] + p - residues[i].mod(p);
+                    uint32_t t = (uint32_t)(diff % p * inv % p);
+                    BigInteger step = M;
+                    step.mulAddSmall(t, 0);
+                    residues[i] = residues[i] + step;
+                }
+                M.mulAddSmall(p, 0);
+                goodPrimes++;
+            }
+            primesUsed += batch;
+
+            if (goodPrimes == 0) {
+                if (skippedPrimes >= SINGULAR_PRIMES) return ExactStatus::Singular;
+                continue;
+            }
+
+            BigInteger half, rem;
+            BigInteger::divMod(M, BigInteger(2), half, rem);
+            BigInteger bound = half.sqrt();
+
+            vector<BigInteger> num(n), den(n);
+            bool ok = true;
+#pragma omp parallel for schedule(dynamic, 4) reduction(&&:ok)
+            for (int i = 0; i < n; i++) {
+                if (ok) ok = reconstruct(residues[i], M, bound, num[i], den[i]);
+            }
+
+            if (ok && (goodPrimes >= certainPrimes || (num == lastNum && den == lastDen))) {
+                numerators = num;
+                denominators = den;
+                return ExactStatus::Solved;
+            }
+            if (ok) {
+                lastNum = num;
+                lastDen = den;
+            }
+        }
+        return ExactStatus::NoConvergence;
+    }
+
+    int getSize() const { return (int)numerators.size(); }
+    const BigInteger& getNumerator(int i) const { return numerators[i]; }
+    const BigInteger& getDenominator(int i) const { return denominators[i]; }
+
+    string valueString(int i) const {
+        if (denominators[i] == BigInteger(1)) return numerators[i].toString();
+        return numerators[i].toString() + "/" + denominators[i].toString();
+    }
+
+    int getPrimesUsed() const { return primesUsed; }
+    int getSkippedPrimes() const { return skippedPrimes; }
+};
+
+#endif
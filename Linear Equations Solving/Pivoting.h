@@ -0,0 +1,165 @@
+#ifndef PIVOTING_H_
+#define PIVOTING_H_
+
+#include "Matrix.h"
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+enum class PivotStrategy { Partial, Rook, Complete };
+
+inline const char* pivotStrategyName(PivotStrategy s) {
+    switch (s) {
+    case PivotStrategy::Rook: return "rook";
+    case PivotStrategy::Complete: return "complete";
+    default: return "partial";
+    }
+}
+
+inline bool parsePivotStrategy(const string& name, PivotStrategy& out) {
+    if (name == "partial") out = PivotStrategy::Partial;
+    else if (name == "rook") out = PivotStrategy::Rook;
+    else if (name == "complete") out = PivotStrategy::Complete;
+    else return false;
+    return true;
+}
+
+struct PivotCandidate {
+    double value;
+    int row;
+    int col;
+
+    // Ties go to the lowest (row, col) so the choice does not depend on how
+    // the search was split across threads.
+    bool beats(const PivotCandidate& other) const {
+        if (value != other.value) return value > other.value;
+        if (row != other.row) return row < other.row;
+        return col < other.col;
+    }
+};
+
+// Pivot searches over the active submatrix A[from.., from..]. Each one is a
+// max-abs reduction: threads scan a slice into a local candidate and merge
+// under a critical section.
+template <typename T>
+class PivotSearch
+{
+private:
+    static const int PARALLEL_THRESHOLD = 512;
+
+public:
+    static PivotCandidate inColumn(Matrix<T>& A, int col, int from, int n) {
+        PivotCandidate best = { -1.0, n, col };
+
+#pragma omp parallel if (n - from > PARALLEL_THRESHOLD)
+        {
+            PivotCandidate local = { -1.0, n, col };
+
+#pragma omp for schedule(static) nowait
+            for (int k = from; k < n; k++) {
+                PivotCandidate c = { (double)abs(A[k][col]), k, col };
+                if (c.beats(local)) local = c;
+            }
+
+#pragma omp critical(pivot_search)
+            if (local.beats(best)) best = local;
+        }
+        return best;
+    }
+
+    static PivotCandidate inRow(Matrix<T>& A, int row, int from, int n) {
+        const T* r = A[row];
+        PivotCandidate best = { -1.0, row, n };
+
+#pragma omp parallel if (n - from > PARALLEL_THRESHOLD)
+        {
+            PivotCandidate local = { -1.0, row, n };
+
+#pragma omp for schedule(static) nowait
+            for (int j = from; j < n; j++) {
+                PivotCandidate c = { (double)abs(r[j]), row, j };
+                if (c.beats(local)) local = c;
+            }
+
+#pragma omp critical(pivot_search)
+            if (local.beats(best)) best = local;
+        }
+        return best;
+    }
+
+    static PivotCandidate inSubmatrix(Matrix<T>& A, int from, int n) {
+        PivotCandidate best = { -1.0, n, n };
+
+#pragma omp parallel if ((long long)(n - from) * (n - from) > PARALLEL_THRESHOLD)
+        {
+            PivotCandidate local = { -1.0, n, n };
+
+#pragma omp for schedule(static) nowait
+            for (int k = from; k < n; k++) {
+                const T* r = A[k];
+                for (int j = from; j < n; j++) {
+                    double v = abs(r[j]);
+                    if (v > local.value) local = { v, k, j };
+                }
+            }
+
+#pragma omp critical(pivot_search)
+            if (local.beats(best)) best = local;
+        }
+        return best;
+    }
+
+    // Alternates column and row searches until the entry is the largest in
+    // both its row and its column. Usually settles in two or three sweeps.
+    static PivotCandidate rook(Matrix<T>& A, int from, int n) {
+        PivotCandidate cur = inColumn(A, from, from, n);
+
+        while (true) {
+            PivotCandidate rowBest = inRow(A, cur.row, from, n);
+            if (rowBest.value <= cur.value) break;
+            cur = rowBest;
+
+            PivotCandidate colBest = inColumn(A, cur.col, from, n);
+            if (colBest.value <= cur.value) break;
+            cur = colBest;
+        }
+        return cur;
+    }
+
+    static PivotCandidate find(PivotStrategy strategy, Matrix<T>& A, int from, int n) {
+        switch (strategy) {
+        case PivotStrategy::Rook: return rook(A, from, n);
+        case PivotStrategy::Complete: return inSubmatrix(A, from, n);
+        default: return inColumn(A, from, from, n);
+        }
+    }
+
+    static double maxAbs(Matrix<T>& A, int rows, int cols) {
+        double m = 0;
+#pragma omp parallel for schedule(static) reduction(max:m)
+        for (int i = 0; i < rows; i++) {
+            const T* r = A[i];
+            for (int j = 0; j < cols; j++) {
+                double v = abs(r[j]);
+                if (v > m) m = v;
+            }
+        }
+        return m;
+    }
+
+    static double maxAbsUpper(Matrix<T>& A, int n) {
+        double m = 0;
+#pragma omp parallel for schedule(static) reduction(max:m)
+        for (int i = 0; i < n; i++) {
+            const T* r = A[i];
+            for (int j = i; j < n; j++) {
+                double v = abs(r[j]);
+                if (v > m) m = v;
+            }
+        }
+        return m;
+    }
+};
+
+#endif
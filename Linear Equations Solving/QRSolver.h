@@ -0,0 +1,295 @@
+#ifndef QRSOLVER_H_
+#define QRSOLVER_H_
+
+#include "Matrix.h"
+#include "TriangularSolver.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Rank-revealing least squares for an m x n system via Householder QR with
+// column pivoting. Full column rank gives the least-squares solution; a rank
+// deficient or under-determined system is finished with an RZ reduction of
+// the leading [R11 R12] rows so the returned x is the minimum-norm solution.
+//
+// A and b are left as Q^T A and Q^T b with the reflectors cleared, which is
+// the same system in upper trapezoidal form.
+//
+// Reflectors are applied to the row-major matrix in column blocks: the
+// w = v^T A pass is split over column blocks so each thread streams a short
+// contiguous slice of every row, and the rank-1 update is split over rows.
+template <typename T>
+class QRSolver
+{
+private:
+    int blockSize;
+    int rank;
+    double residualNorm;
+    double determinant;
+
+    static const int PARALLEL_WORK_THRESHOLD = 1 << 14;
+
+    // Builds the reflector that maps (alpha, rest) to (beta, 0) and returns
+    // tau; rest is overwritten with the reflector tail (the head is 1).
+    static T makeReflector(T& alpha, T** rest, int col, int count) {
+        double sigma = 0;
+        for (int i = 0; i < count; i++) sigma += (double)rest[i][col] * rest[i][col];
+        if (sigma == 0) return 0;
+
+        double norm = sqrt((double)alpha * alpha + sigma);
+        double beta = (alpha <= 0) ? norm : -norm;
+        double scale = 1.0 / (alpha - beta);
+        for (int i = 0; i < count; i++) rest[i][col] *= (T)scale;
+
+        T tau = (T)((beta - alpha) / beta);
+        alpha = (T)beta;
+        return tau;
+    }
+
+    // Applies I - tau v v^T (v stored in column k of rows k+1..m-1, head 1)
+    // to columns k+1..n-1 and to b.
+    void applyReflector(T** rows, int k, int m, int n, T tau, T* b, T* w) {
+        int width = n - (k + 1);
+        long long work = (long long)(m - k) * width;
+
+        if (width > 0) {
+            int blocks = (width + blockSize - 1) / blockSize;
+
+#pragma omp parallel for schedule(static) if (work > PARALLEL_WORK_THRESHOLD)
+            for (int blk = 0; blk < blocks; blk++) {
+                int from = k + 1 + blk * blockSize;
+                int to = min(from + blockSize, n);
+
+                const T* pivotRow = rows[k];
+                for (int j = from; j < to; j++) w[j] = pivotRow[j];
+
+                for (int i = k + 1; i < m; i++) {
+                    const T* r = rows[i];
+                    T vi = r[k];
+#pragma omp simd
+                    for (int j = from; j < to; j++) w[j] += vi * r[j];
+                }
+            }
+
+            T* pivotRow = rows[k];
+#pragma omp simd
+            for (int j = k + 1; j < n; j++) pivotRow[j] -= tau * w[j];
+
+#pragma omp parallel for schedule(static) if (work > PARALLEL_WORK_THRESHOLD)
+            for (int i = k + 1; i < m; i++) {
+                T* r = rows[i];
+                T s = tau * r[k];
+#pragma omp simd
+                for (int j = k + 1; j < n; j++) r[j] -= s * w[j];
+            }
+        }
+
+        T dot = b[k];
+        for (int i = k + 1; i < m; i++) dot += rows[i][k] * b[i];
+        b[k] -= tau * dot;
+        for (int i = k + 1; i < m; i++) b[i] -= tau * rows[i][k] * dot;
+    }
+
+public:
+    explicit QRSolver(int block = 64)
+        : blockSize(block > 0 ? block : 64), rank(0), residualNorm(0), determinant(0) {
+    }
+
+    // Overwrites A and b with Q^T A and Q^T b. tolerance is relative to the
+    // largest column norm; columns whose remaining norm falls below it are
+    // treated as dependent.
+    int solve(Matrix<T>& A, T* b, int m, int n, T* x, double tolerance) {
+        rank = 0;
+        residualNorm = 0;
+        determinant = 0;
+        for (int j = 0; j < n; j++) x[j] = 0;
+        if (m <= 0 || n <= 0) return 0;
+
+        T** rows = new T * [m];
+        for (int i = 0; i < m; i++) rows[i] = A[i];
+
+        int* perm = new int[n];
+        double* norms = new double[n];
+        double* origNorms = new double[n];
+        T* w = new T[n];
+
+        for (int j = 0; j < n; j++) {
+            perm[j] = j;
+            norms[j] = 0;
+        }
+
+        for (int i = 0; i < m; i++) {
+            const T* r = rows[i];
+            for (int j = 0; j < n; j++) norms[j] += (double)r[j] * r[j];
+        }
+        for (int j = 0; j < n; j++) origNorms[j] = norms[j];
+
+        double maxNorm = 0;
+        for (int j = 0; j < n; j++) maxNorm = max(maxNorm, norms[j]);
+        double cutoff = tolerance * tolerance * maxNorm;
+
+        int sign = 1;
+        int steps = min(m, n);
+        for (int k = 0; k < steps; k++) {
+            int p = k;
+            for (int j = k + 1; j < n; j++) {
+                if (norms[j] > norms[p]) p = j;
+            }
+
+            if (maxNorm == 0 || norms[p] <= cutoff) break;
+
+            if (p != k) {
+                A.swapCols(k, p);
+                std::swap(perm[k], perm[p]);
+                std::swap(norms[k], norms[p]);
+                std::swap(origNorms[k], origNorms[p]);
+                sign = -sign;
+            }
+
+            T tau = makeReflector(rows[k][k], rows + k + 1, k, m - k - 1);
+            applyReflector(rows, k, m, n, tau, b, w);
+            if (tau != 0) sign = -sign;
+            rank++;
+
+            // Downdate the remaining column norms; recompute when cancellation
+            // has eaten most of the significant digits.
+            for (int j = k + 1; j < n; j++) {
+                double rkj = rows[k][j];
+                norms[j] -= rkj * rkj;
+                if (norms[j] <= 1e-8 * origNorms[j]) {
+                    double s = 0;
+                    for (int i = k + 1; i < m; i++) s += (double)rows[i][j] * rows[i][j];
+                    norms[j] = s;
+                    origNorms[j] = s;
+                }
+            }
+        }
+
+        // The tails below the diagonal are the reflectors; Q^T A has zeros
+        // there.
+#pragma omp parallel for schedule(static)
+        for (int i = 1; i < m; i++) {
+            T* r = rows[i];
+            int end = min(i, rank);
+            for (int j = 0; j < end; j++) r[j] = 0;
+        }
+
+        if (m == n && rank == n) {
+            double det = sign;
+            for (int k = 0; k < n; k++) det *= rows[k][k];
+            determinant = det;
+        }
+
+        for (int i = rank; i < m; i++) residualNorm += (double)b[i] * b[i];
+        residualNorm = sqrt(residualNorm);
+
+        T* y = new T[n];
+        for (int j = 0; j < n; j++) y[j] = 0;
+        for (int i = 0; i < rank; i++) y[i] = b[i];
+
+        if (rank < n && rank > 0) {
+            // RZ: fold columns rank..n-1 into the leading triangle with
+            // reflectors from the right, T = [R 0] Z.
+            T* taus = new T[rank];
+
+            for (int k = rank - 1; k >= 0; k--) {
+                T* rk = rows[k];
+                double sigma = 0;
+                for (int j = rank; j < n; j++) sigma += (double)rk[j] * rk[j];
+
+                if (sigma == 0) {
+                    taus[k] = 0;
+                    continue;
+                }
+
+                double alpha = rk[k];
+                double norm = sqrt(alpha * alpha + sigma);
+                double beta = (alpha <= 0) ? norm : -norm;
+                double scale = 1.0 / (alpha - beta);
+                for (int j = rank; j < n; j++) rk[j] *= (T)scale;
+                taus[k] = (T)((beta - alpha) / beta);
+                rk[k] = (T)beta;
+
+#pragma omp parallel for schedule(static) if ((long long)k * (n - rank) > PARALLEL_WORK_THRESHOLD)
+                for (int i = 0; i < k; i++) {
+                    T* ri = rows[i];
+                    T s = ri[k];
+                    for (int j = rank; j < n; j++) s += ri[j] * rk[j];
+                    s *= taus[k];
+                    ri[k] -= s;
+                    for (int j = rank; j < n; j++) ri[j] -= s * rk[j];
+                }
+            }
+
+            TriangularSolver<T>(blockSize).solveUpper(A, y, rank);
+
+            for (int k = 0; k < rank; k++) {
+                if (taus[k] == 0) continue;
+                const T* rk = rows[k];
+                T s = y[k];
+                for (int j = rank; j < n; j++) s += rk[j] * y[j];
+                s *= taus[k];
+                y[k] -= s;
+                for (int j = rank; j < n; j++) y[j] -= s * rk[j];
+            }
+
+            // Undo the RZ reduction on A in reverse order; each reflector is
+            // its own inverse, and row k is rebuilt from beta and its tail.
+            for (int k = 0; k < rank; k++) {
+                if (taus[k] == 0) continue;
+                T* rk = rows[k];
+
+#pragma omp parallel for schedule(static) if ((long long)k * (n - rank) > PARALLEL_WORK_THRESHOLD)
+                for (int i = 0; i < k; i++) {
+                    T* ri = rows[i];
+                    T s = ri[k];
+                    for (int j = rank; j < n; j++) s += ri[j] * rk[j];
+                    s *= taus[k];
+                    ri[k] -= s;
+                    for (int j = rank; j < n; j++) ri[j] -= s * rk[j];
+                }
+
+                T beta = rk[k];
+                rk[k] = beta * (1 - taus[k]);
+                for (int j = rank; j < n; j++) rk[j] *= -beta * taus[k];
+            }
+
+            delete[] taus;
+        }
+        else if (rank > 0) {
+            TriangularSolver<T>(blockSize).solveUpper(A, y, rank);
+        }
+
+        for (int j = 0; j < n; j++) x[perm[j]] = y[j];
+
+        // Leave A in the caller's column order.
+        for (int j = 0; j < n; j++) {
+            while (perm[j] != j) {
+                int target = perm[j];
+                A.swapCols(j, target);
+                std::swap(perm[j], perm[target]);
+            }
+        }
+
+        delete[] y;
+        delete[] w;
+        delete[] origNorms;
+        delete[] norms;
+        delete[] perm;
+        delete[] rows;
+
+        return rank;
+    }
+
+    int getRank() const { return rank; }
+
+    // det(A) of a square system, signed for the column swaps and
+    // reflections; 0 when it is rank deficient.
+    double getDeterminant() const { return determinant; }
+
+    // 2-norm of the part of b outside the range of A, i.e. ||Ax - b||.
+    double getResidualNorm() const { return residualNorm; }
+};
+
+#endif
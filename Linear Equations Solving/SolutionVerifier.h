@@ -0,0 +1,212 @@
+#ifndef SOLUTIONVERIFIER_H_
+#define SOLUTIONVERIFIER_H_
+
+#include "Equation.h"
+#include "SymbolTable.h"
+#include <string>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <omp.h>
+
+using namespace std;
+
+// How well x satisfies the system it was solved from. backwardError is the
+// normwise (Rigal-Gaches) backward error ||Ax - b|| / (||A|| ||x|| + ||b||)
+// in the infinity norm: the smallest relative change to A and b that makes
+// x exact. Values near machine epsilon mean a backward stable solve.
+struct VerificationReport {
+    int rows;
+    int skipped;
+    double residualMax;
+    double residualTwo;
+    double matrixNorm;
+    double solutionNorm;
+    double rhsNorm;
+    double backwardError;
+};
+
+// Measures a solution against the original equations after elimination has
+// overwritten A. Rows are fed in batches, either as the equation text (each
+// row scattered into a per-thread dense buffer) or as dense rows replayed
+// from wherever they came from, so no copy of A is ever held. Every row
+// residual is a row-parallel GEMV whose dot products use compensated
+// (dot2) summation over independent SIMD lanes, so the residual is as
+// accurate as if computed in twice the working precision, even when it is
+// far smaller than the terms it is made of.
+template <typename T>
+class SolutionVerifier
+{
+private:
+    const T* x;
+    int n;
+    const SymbolTable* symbols;
+    int rows;
+    int skipped;
+    double residualMax;
+    double residualSquares;
+    double matrixNorm;
+    double rhsNorm;
+
+    static const int LANES = 8;
+
+    // Error-free transformations: a + b == s + e and a * b == p + e exactly.
+    static inline void twoSum(T a, T b, T& s, T& e) {
+        s = a + b;
+        T z = s - a;
+        e = (a - (s - z)) + (b - z);
+    }
+
+    static inline void twoProduct(T a, T b, T& p, T& e) {
+        p = a * b;
+#ifdef FP_FAST_FMA
+        e = fma(a, b, -p);
+#else
+        // Dekker's product through Veltkamp splitting when fma is not a
+        // single instruction.
+        const T factor = (T)((1LL << ((numeric_limits<T>::digits + 1) / 2)) + 1);
+        T ca = factor * a, cb = factor * b;
+        T ah = ca - (ca - a), al = a - ah;
+        T bh = cb - (cb - b), bl = b - bh;
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+    }
+
+public:
+    // 'names' maps equation variables to indices of 'solution'; it is only
+    // needed for addEquations.
+    SolutionVerifier(const T* solution, int variables, const SymbolTable* names = nullptr)
+        : x(solution), n(variables), symbols(names), rows(0), skipped(0),
+        residualMax(0), residualSquares(0), matrixNorm(0), rhsNorm(0) {
+    }
+
+    // a . v - b with dot2 summation.
+    static T residual(const T* a, const T* v, int count, T b) {
+        T s[LANES] = {}, c[LANES] = {};
+        s[0] = -b;
+
+        int j = 0;
+        for (; j + LANES <= count; j += LANES) {
+#pragma omp simd
+            for (int l = 0; l < LANES; l++) {
+                T p, ep, sum, es;
+                twoProduct(a[j + l], v[j + l], p, ep);
+                twoSum(s[l], p, sum, es);
+                s[l] = sum;
+                c[l] += es + ep;
+            }
+        }
+        for (; j < count; j++) {
+            T p, ep, sum, es;
+            twoProduct(a[j], v[j], p, ep);
+            twoSum(s[0], p, sum, es);
+            s[0] = sum;
+            c[0] += es + ep;
+        }
+
+        T total = 0, correction = 0;
+        for (int l = 0; l < LANES; l++) {
+            T sum, e;
+            twoSum(total, s[l], sum, e);
+            total = sum;
+            correction += e + c[l];
+        }
+        return total + correction;
+    }
+
+    // 'count' dense rows of n entries, row-major, with their constants.
+    void addRows(const T* a, const T* b, int count) {
+        double rMax = 0, rSquares = 0, aNorm = 0, bNorm = 0;
+
+#pragma omp parallel for schedule(static) reduction(max:rMax, aNorm, bNorm) reduction(+:rSquares)
+        for (int i = 0; i < count; i++) {
+            const T* row = a + (size_t)i * n;
+            double r = (double)residual(row, x, n, b[i]);
+            T rowNorm = 0;
+#pragma omp simd reduction(+:rowNorm)
+            for (int j = 0; j < n; j++) rowNorm += fabs(row[j]);
+
+            rMax = max(rMax, fabs(r));
+            rSquares += r * r;
+            aNorm = max(aNorm, (double)rowNorm);
+            bNorm = max(bNorm, fabs((double)b[i]));
+        }
+
+        residualMax = max(residualMax, rMax);
+        residualSquares += rSquares;
+        matrixNorm = max(matrixNorm, aNorm);
+        rhsNorm = max(rhsNorm, bNorm);
+        rows += count;
+    }
+
+    // Equations as they were entered. Lines that do not parse or name a
+    // variable the solution does not have are counted as skipped. Returns
+    // how many lines were checked.
+    int addEquations(const vector<string>& lines) {
+        int count = (int)lines.size();
+        double rMax = 0, rSquares = 0, aNorm = 0, bNorm = 0;
+        int checked = 0;
+
+#pragma omp parallel reduction(max:rMax, aNorm, bNorm) reduction(+:rSquares, checked)
+        {
+            vector<T> row(n, 0);
+            vector<int> touched;
+            Equation eq;
+
+#pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < count; i++) {
+                if (eq.parse(lines[i]) != ParseStatus::Ok) continue;
+
+                Vector<Term>& terms = eq.getTerms();
+                bool known = true;
+                touched.clear();
+                for (int k = 0; k < terms.getSize() && known; k++) {
+                    int col = symbols ? symbols->find(eq.nameOf(terms[k]), terms[k].nameLength) : -1;
+                    if (col < 0 || col >= n) {
+                        known = false;
+                        continue;
+                    }
+                    row[col] += (T)terms[k].value;
+                    touched.push_back(col);
+                }
+
+                if (known) {
+                    T b = (T)eq.getConstant();
+                    double r = (double)residual(row.data(), x, n, b);
+                    T rowNorm = 0;
+#pragma omp simd reduction(+:rowNorm)
+                    for (int j = 0; j < n; j++) rowNorm += fabs(row[j]);
+
+                    rMax = max(rMax, fabs(r));
+                    rSquares += r * r;
+                    aNorm = max(aNorm, (double)rowNorm);
+                    bNorm = max(bNorm, fabs((double)b));
+                    checked++;
+                }
+
+                for (int col : touched) row[col] = 0;
+            }
+        }
+
+        residualMax = max(residualMax, rMax);
+        residualSquares += rSquares;
+        matrixNorm = max(matrixNorm, aNorm);
+        rhsNorm = max(rhsNorm, bNorm);
+        rows += checked;
+        skipped += count - checked;
+        return checked;
+    }
+
+    VerificationReport report() const {
+        double xNorm = 0;
+#pragma omp parallel for schedule(static) reduction(max:xNorm)
+        for (int j = 0; j < n; j++) xNorm = max(xNorm, fabs((double)x[j]));
+
+        double scale = matrixNorm * xNorm + rhsNorm;
+        return { rows, skipped, residualMax, sqrt(residualSquares), matrixNorm, xNorm, rhsNorm,
+            scale > 0 ? residualMax / scale : residualMax };
+    }
+};
+
+#endif
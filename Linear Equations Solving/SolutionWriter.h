@@ -0,0 +1,195 @@
+#ifndef SOLUTIONWRITER_H_
+#define SOLUTIONWRITER_H_
+
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fcntl.h>
+#include <omp.h>
+#include "SymbolTable.h"
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+enum class SolutionFormat { Text, Csv, Binary };
+
+inline bool parseSolutionFormat(const string& name, SolutionFormat& out) {
+    if (name == "text" || name == "txt") out = SolutionFormat::Text;
+    else if (name == "csv") out = SolutionFormat::Csv;
+    else if (name == "bin" || name == "binary") out = SolutionFormat::Binary;
+    else return false;
+    return true;
+}
+
+// Bulk solution output straight to a file descriptor. Values are formatted
+// with std::to_chars into per-chunk buffers; a round of chunks is formatted
+// in parallel and then written in order, so memory stays bounded at
+// CHUNK * threads entries and the stream is only touched once per chunk.
+//
+// precision 0 writes the shortest representation that round-trips; any
+// other value matches printf("%.*g"), i.e. what cout prints by default at 6.
+//
+// With a symbol table, entry k is column order[k] labelled by its name
+// (?<column> for columns nothing named); without one, entry k is x<k+1>.
+template <typename T>
+class SolutionWriter
+{
+private:
+    static const int CHUNK = 1 << 15;
+    static const int MAX_ENTRY = 64;
+
+    static bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+#ifdef _WIN32
+            int w = _write(fd, data, (unsigned int)(size > (1u << 30) ? (1u << 30) : size));
+#else
+            ssize_t w = ::write(fd, data, size);
+#endif
+            if (w <= 0) return false;
+            data += w;
+            size -= (size_t)w;
+        }
+        return true;
+    }
+
+    static char* formatValue(char* p, char* end, T value, int precision) {
+        if (precision > 0) return to_chars(p, end, value, chars_format::general, precision).ptr;
+        return to_chars(p, end, value).ptr;
+    }
+
+    static size_t chunkCapacity(int from, int to, const SymbolTable* names, const int* order) {
+        size_t bytes = (size_t)(to - from) * MAX_ENTRY;
+        if (names) {
+            for (int i = from; i < to; i++) {
+                if (order[i] < names->size()) bytes += names->nameLength(order[i]);
+            }
+        }
+        return bytes;
+    }
+
+    static size_t formatChunk(char* buf, size_t capacity, const T* x, int from, int to, SolutionFormat format,
+        int precision, int stride, const SymbolTable* names, const int* order) {
+        char* p = buf;
+        char* end = buf + capacity;
+
+        for (int i = from; i < to; i++) {
+            int col = order ? order[i] : i;
+            if (!names) {
+                *p++ = 'x';
+                p = to_chars(p, end, i + 1).ptr;
+            }
+            else if (col < names->size()) {
+                memcpy(p, names->nameData(col), names->nameLength(col));
+                p += names->nameLength(col);
+            }
+            else {
+                *p++ = '?';
+                p = to_chars(p, end, col + 1).ptr;
+            }
+            if (format == SolutionFormat::Csv) {
+                *p++ = ',';
+            }
+            else {
+                memcpy(p, " = ", 3);
+                p += 3;
+            }
+            p = formatValue(p, end, x[(size_t)col * stride], precision);
+            *p++ = '\n';
+        }
+        return (size_t)(p - buf);
+    }
+
+public:
+    // stride > 1 reads every stride-th value, e.g. one column of a row-major
+    // block of solutions.
+    static bool write(int fd, const T* x, int n, SolutionFormat format, int precision = 0, int stride = 1,
+        const SymbolTable* names = nullptr, const int* order = nullptr) {
+        if (names && !order) names = nullptr;
+
+        if (format == SolutionFormat::Binary) {
+            int64_t count = n;
+            if (!writeAll(fd, (const char*)&count, sizeof(count))) return false;
+            if (stride == 1 && !order) return writeAll(fd, (const char*)x, sizeof(T) * (size_t)n);
+
+            vector<T> column(n);
+            for (int i = 0; i < n; i++) column[i] = x[(size_t)(order ? order[i] : i) * stride];
+            return writeAll(fd, (const char*)column.data(), sizeof(T) * (size_t)n);
+        }
+
+        if (format == SolutionFormat::Csv) {
+            const char header[] = "variable,value\n";
+            if (!writeAll(fd, header, sizeof(header) - 1)) return false;
+        }
+
+        int chunks = (n + CHUNK - 1) / CHUNK;
+        int perRound = 1;
+#ifdef _OPENMP
+        perRound = omp_get_max_threads();
+#endif
+
+        vector<vector<char>> buffers(perRound);
+        vector<size_t> used(perRound);
+        bool ok = true;
+
+        for (int first = 0; first < chunks && ok; first += perRound) {
+            int count = (chunks - first < perRound) ? chunks - first : perRound;
+
+#pragma omp parallel for schedule(static, 1) if (count > 1)
+            for (int c = 0; c < count; c++) {
+                int from = (first + c) * CHUNK;
+                int to = (from + CHUNK < n) ? from + CHUNK : n;
+                size_t capacity = chunkCapacity(from, to, names, order);
+                buffers[c].resize(capacity);
+                used[c] = formatChunk(buffers[c].data(), capacity, x, from, to, format, precision, stride, names, order);
+            }
+
+            for (int c = 0; c < count && ok; c++) ok = writeAll(fd, buffers[c].data(), used[c]);
+        }
+
+        return ok;
+    }
+
+    static bool writeFile(const string& path, const T* x, int n, SolutionFormat format, int precision = 0,
+        const SymbolTable* names = nullptr, const int* order = nullptr) {
+#ifdef _WIN32
+        int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (fd < 0) return false;
+
+        bool ok = write(fd, x, n, format, precision, 1, names, order);
+#ifdef _WIN32
+        ok = (_close(fd) == 0) && ok;
+#else
+        ok = (::close(fd) == 0) && ok;
+#endif
+        return ok;
+    }
+
+    // Writes to stdout, flushing iostream and stdio first so nothing queued
+    // there ends up after the solution.
+    static bool writeStdout(const T* x, int n, SolutionFormat format, int precision = 0, int stride = 1,
+        const SymbolTable* names = nullptr, const int* order = nullptr) {
+        cout.flush();
+        fflush(stdout);
+        return write(1, x, n, format, precision, stride, names, order);
+    }
+
+    static bool writeStdoutText(const char* text) {
+        cout.flush();
+        fflush(stdout);
+        return writeAll(1, text, strlen(text));
+    }
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SOLVECONTROL_H_
+#define SOLVECONTROL_H_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+enum class SolveStatus { Solved, NoUniqueSolution, Cancelled, DeadlineExceeded };
+
+inline const char* solveStatusMessage(SolveStatus status) {
+    switch (status) {
+    case SolveStatus::Solved: return "solved";
+    case SolveStatus::Cancelled: return "cancelled";
+    case SolveStatus::DeadlineExceeded: return "deadline exceeded";
+    default: return "no unique solution";
+    }
+}
+
+// What a solver reports at a checkpoint: elimination step (or panel start)
+// 'step' of 'total', or iteration 'step' of at most 'total' with the
+// residual it measured. residual is negative for direct solvers.
+struct SolveProgress {
+    const char* phase;
+    int step;
+    int total;
+    double residual;
+};
+
+// Shared between a caller and a running solve. Solvers call checkpoint() at
+// cheap points between parallel regions (once per pivot step, panel or
+// iteration), so a stop request takes effect at the next step and no
+// OpenMP team is left waiting. cancel() only stores a lock-free atomic and
+// may be called from any thread or from a signal handler. The progress
+// callback runs on the solving thread, at most once per reportInterval.
+class SolveControl
+{
+private:
+    atomic<bool> cancelled;
+    atomic<int> stopReason;
+    bool hasDeadline;
+    chrono::steady_clock::time_point deadline;
+    function<void(const SolveProgress&)> onProgress;
+    chrono::steady_clock::duration reportInterval;
+    chrono::steady_clock::time_point lastReport;
+
+public:
+    SolveControl() : cancelled(false), stopReason((int)SolveStatus::Solved), hasDeadline(false),
+        reportInterval(chrono::milliseconds(100)) {
+    }
+
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(); }
+
+    void setDeadline(chrono::steady_clock::time_point when) {
+        deadline = when;
+        hasDeadline = true;
+    }
+
+    void setTimeout(double seconds) {
+        setDeadline(chrono::steady_clock::now()
+            + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds)));
+    }
+
+    void setProgressCallback(function<void(const SolveProgress&)> callback,
+        chrono::milliseconds interval = chrono::milliseconds(100)) {
+        onProgress = move(callback);
+        reportInterval = interval;
+    }
+
+    // Reports progress if a report is due and returns true when the solve
+    // should stop; stopStatus() then says why.
+    bool checkpoint(const char* phase, int step, int total, double residual = -1) {
+        if (!onProgress && !hasDeadline) return isStopped();
+
+        auto now = chrono::steady_clock::now();
+        if (onProgress && (step == 0 || now - lastReport >= reportInterval)) {
+            lastReport = now;
+            onProgress({ phase, step, total, residual });
+        }
+        if (hasDeadline && now >= deadline) stopReason.store((int)SolveStatus::DeadlineExceeded);
+        return isStopped();
+    }
+
+    bool isStopped() {
+        if (cancelled.load()) stopReason.store((int)SolveStatus::Cancelled);
+        return stopReason.load() != (int)SolveStatus::Solved;
+    }
+
+    // Cancelled or DeadlineExceeded once a checkpoint has stopped the solve,
+    // Solved otherwise.
+    SolveStatus stopStatus() const { return (SolveStatus)stopReason.load(); }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef SOLVERAUTOTUNER_H_
+#define SOLVERAUTOTUNER_H_
+
+#include "SolverBackend.h"
+#include "LinearSystem.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <omp.h>
+
+using namespace std;
+
+struct TunedChoice {
+    int bucketSize;
+    string backend;
+    TuningParams params;
+};
+
+// Picks a backend per problem size. The first run benchmarks every dense
+// backend over a grid of block sizes, thread counts and schedules on random
+// systems at a few representative sizes, then writes the winners to a cache
+// file so later runs go straight to dispatch. Structure overrides size:
+// rectangular systems go to QR and diagonally dominant ones try Jacobi first.
+template <typename T>
+class SolverAutotuner
+{
+private:
+    string cachePath;
+    vector<TunedChoice> choices;
+    string lastBackend;
+
+    static int availableThreads() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    bool load() {
+        ifstream in(cachePath);
+        if (!in) return false;
+
+        vector<TunedChoice> loaded;
+        string line;
+        int threads = -1;
+
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            stringstream ss(line);
+            string key;
+            ss >> key;
+
+            if (key == "threads_available") {
+                ss >> threads;
+            }
+            else if (key == "bucket") {
+                TunedChoice c;
+                string schedule;
+                if (ss >> c.bucketSize >> c.backend >> c.params.blockSize >> c.params.threads >> schedule) {
+                    c.params.guidedSchedule = (schedule == "guided");
+                    if (SolverRegistry<T>::find(c.backend)) loaded.push_back(c);
+                }
+            }
+        }
+
+        // A cache written on a host with a different core count is stale.
+        if (threads != availableThreads() || loaded.empty()) return false;
+        choices = loaded;
+        return true;
+    }
+
+    void save() const {
+        ofstream out(cachePath);
+        if (!out) return;
+
+        out << "# LinearSolver autotuning cache: bucket <n> <backend> <block> <threads> <schedule>\n";
+        out << "threads_available " << availableThreads() << "\n";
+        for (const TunedChoice& c : choices) {
+            out << "bucket " << c.bucketSize << " " << c.backend << " " << c.params.blockSize << " "
+                << c.params.threads << " " << (c.params.guidedSchedule ? "guided" : "static") << "\n";
+        }
+    }
+
+public:
+    explicit SolverAutotuner(const string& path = "solver_tuning.cfg") : cachePath(path) {}
+
+    static vector<int> bucketSizes() { return { 64, 256, 512 }; }
+
+    static void fillRandom(LinearSystem<T>& sys, mt19937& rng) {
+        uniform_int_distribution<int> dist(-100, 100);
+        Matrix<T>& A = *sys.getMatrix();
+        Vector<T>& B = *sys.getConstants();
+        int n = sys.getSize();
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) A[i][j] = (T)dist(rng);
+            B[i] = (T)dist(rng);
+        }
+    }
+
+    // Replays the rows fillRandom drew from 'rng' in batches and checks x
+    // against them, since the solve has overwritten A by now.
+    static VerificationReport verifyRandom(const T* x, int n, mt19937& rng) {
+        uniform_int_distribution<int> dist(-100, 100);
+        SolutionVerifier<T> verifier(x, n);
+        int batch = max(1, min(n, (1 << 20) / max(n, 1)));
+        vector<T> rows((size_t)batch * n), b(batch);
+
+        for (int first = 0; first < n; first += batch) {
+            int count = min(batch, n - first);
+            for (int i = 0; i < count; i++) {
+                for (int j = 0; j < n; j++) rows[(size_t)i * n + j] = (T)dist(rng);
+                b[i] = (T)dist(rng);
+            }
+            verifier.addRows(rows.data(), b.data(), count);
+        }
+        return verifier.report();
+    }
+
+    // Best time over 'reps' random systems; 'check', when given, receives
+    // the verification of the last solve.
+    static double timeBackend(SolverBackend<T>& backend, const TuningParams& params, int n, int reps,
+        VerificationReport* check = nullptr) {
+        double best = -1;
+        for (int r = 0; r < reps; r++) {
+            mt19937 rng(12345 + r);
+            LinearSystem<T> sys(n);
+            fillRandom(sys, rng);
+
+            auto start = chrono::high_resolution_clock::now();
+            bool ok = backend.run(&sys, params);
+            auto end = chrono::high_resolution_clock::now();
+
+            if (!ok) return -1;
+            double t = chrono::duration<double>(end - start).count();
+            if (best < 0 || t < best) best = t;
+
+            if (check && r == reps - 1) {
+                mt19937 replay(12345 + r);
+                *check = verifyRandom(&(*sys.getResult())[0], n, replay);
+            }
+        }
+        return best;
+    }
+
+    // Loads the cache, or benchmarks and writes it when missing or stale.
+    // Returns true when a fresh tuning run happened.
+    bool ensureTuned(bool verbose = false) {
+        if (load()) return false;
+        tune(verbose);
+        save();
+        return true;
+    }
+
+    void tune(bool verbose = false) {
+        choices.clear();
+
+        int maxThreads = availableThreads();
+        vector<int> threadOptions = { maxThreads };
+        if (maxThreads > 2) threadOptions.push_back(maxThreads / 2);
+        if (maxThreads > 1) threadOptions.push_back(1);
+
+        vector<int> blockOptions = { 32, 64, 128 };
+
+        for (int n : bucketSizes()) {
+            TunedChoice best;
+            best.bucketSize = n;
+            best.backend = "parallel";
+            best.params = { 64, maxThreads, true };
+            double bestTime = -1;
+
+            SystemProfile profile = { n, n, 1.0, false };
+            int reps = (n <= 64) ? 5 : 2;
+
+            for (auto& backend : SolverRegistry<T>::all()) {
+                if (!backend->supports(profile) || backend->getName() == "qr") continue;
+
+                vector<int> blocks = backend->usesBlockSize() ? blockOptions : vector<int>{ 64 };
+                vector<int> threads = (backend->getName() == "naive") ? vector<int>{ 1 } : threadOptions;
+                vector<int> schedules = backend->usesSchedule() ? vector<int>{ 0, 1 } : vector<int>{ 1 };
+
+                for (int b : blocks) {
+                    for (int t : threads) {
+                        for (int guided : schedules) {
+                            TuningParams params = { b, t, guided == 1 };
+                            double time = timeBackend(*backend, params, n, reps);
+                            if (time < 0) continue;
+
+                            if (verbose) {
+                                cout << "  n=" << n << " " << backend->getName() << " block=" << b
+                                    << " threads=" << t << " " << (guided ? "guided" : "static")
+                                    << ": " << time << " s" << endl;
+                            }
+                            if (bestTime < 0 || time < bestTime) {
+                                bestTime = time;
+                                best.backend = backend->getName();
+                                best.params = params;
+                            }
+                        }
+                    }
+                }
+            }
+
+            choices.push_back(best);
+        }
+    }
+
+    TunedChoice choose(const SystemProfile& profile) const {
+        TunedChoice pick = { 0, "parallel", { 64, availableThreads(), true } };
+        if (choices.empty()) return pick;
+
+        // Nearest bucket on a log scale; anything larger than the biggest
+        // benchmarked size uses the biggest.
+        int n = profile.variables;
+        double bestDist = -1;
+        for (const TunedChoice& c : choices) {
+            double dist = abs(log((double)max(n, 1)) - log((double)c.bucketSize));
+            if (n > c.bucketSize && &c == &choices.back()) dist = 0;
+            if (bestDist < 0 || dist < bestDist) {
+                bestDist = dist;
+                pick = c;
+            }
+        }
+        return pick;
+    }
+
+    bool solve(LinearSystem<T>* sys) {
+        SystemProfile profile = SolverRegistry<T>::profile(sys);
+
+        if (profile.equations != profile.variables) {
+            lastBackend = "qr";
+            TuningParams params = { 64, availableThreads(), false };
+            return SolverRegistry<T>::find("qr")->run(sys, params);
+        }
+
+        TunedChoice pick = choose(profile);
+
+        if (profile.diagonallyDominant) {
+            auto iterative = SolverRegistry<T>::find("iterative");
+            if (iterative->run(sys, pick.params)) {
+                lastBackend = "iterative";
+                return true;
+            }
+        }
+
+        lastBackend = pick.backend;
+        return SolverRegistry<T>::find(pick.backend)->run(sys, pick.params);
+    }
+
+    const vector<TunedChoice>& getChoices() const { return choices; }
+    string getLastBackend() const { return lastBackend; }
+};
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef SOLVERBACKEND_H_
+#define SOLVERBACKEND_H_
+
+#include "LinearSystem.h"
+#include "GaussianSolver.h"
+#include "BlockedSolver.h"
+#include "CALUSolver.h"
+#include "IterativeSolver.h"
+#include "LapackSolver.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <omp.h>
+
+using namespace std;
+
+struct TuningParams {
+    int blockSize;
+    int threads;
+    bool guidedSchedule;
+};
+
+struct SystemProfile {
+    int equations;
+    int variables;
+    double density;
+    bool diagonallyDominant;
+};
+
+// Common entry point for every way this project can solve a LinearSystem.
+// A backend reports which shapes it handles and runs with the thread count
+// and scheduling from TuningParams; backends without a block size ignore it.
+template <typename T>
+class SolverBackend
+{
+protected:
+    double growthFactor = 0;
+
+public:
+    virtual ~SolverBackend() {}
+
+    virtual string getName() const = 0;
+
+    virtual bool supports(const SystemProfile& profile) const {
+        return profile.equations == profile.variables;
+    }
+
+    virtual bool usesBlockSize() const { return false; }
+    // True when the backend's parallel loops use schedule(runtime), so the
+    // guidedSchedule parameter changes anything.
+    virtual bool usesSchedule() const { return false; }
+
+    bool run(LinearSystem<T>* sys, const TuningParams& params) {
+#ifdef _OPENMP
+        int previousThreads = omp_get_max_threads();
+        omp_sched_t previousKind;
+        int previousChunk;
+        omp_get_schedule(&previousKind, &previousChunk);
+
+        if (params.threads > 0) omp_set_num_threads(params.threads);
+        omp_set_schedule(params.guidedSchedule ? omp_sched_guided : omp_sched_static, 0);
+#endif
+        growthFactor = 0;
+        bool ok = solve(sys, params);
+#ifdef _OPENMP
+        omp_set_num_threads(previousThreads);
+        omp_set_schedule(previousKind, previousChunk);
+#endif
+        return ok;
+    }
+
+    // max|U| / max|A| of the last run for backends that factor with
+    // pivoting, 0 for the rest.
+    double getGrowthFactor() const { return growthFactor; }
+
+protected:
+    virtual bool solve(LinearSystem<T>* sys, const TuningParams& params) = 0;
+};
+
+template <typename T>
+class NaiveBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "naive"; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams&) override {
+        return GaussianSolver<T>().solve(sys);
+    }
+};
+
+template <typename T>
+class ParallelBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "parallel"; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams&) override {
+        bool ok = sys->solve();
+        this->growthFactor = sys->getGrowthFactor();
+        return ok;
+    }
+};
+
+template <typename T>
+class BlockedBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "blocked"; }
+    bool usesBlockSize() const override { return true; }
+    bool usesSchedule() const override { return true; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams& params) override {
+        BlockedSolver<T> solver(params.blockSize);
+        bool ok = solver.solve(sys);
+        this->growthFactor = solver.getGrowthFactor();
+        return ok;
+    }
+};
+
+template <typename T>
+class CALUBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "calu"; }
+    bool usesBlockSize() const override { return true; }
+    bool usesSchedule() const override { return true; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams& params) override {
+        CALUSolver<T> solver(params.blockSize);
+        bool ok = solver.solve(sys);
+        this->growthFactor = solver.getGrowthFactor();
+        return ok;
+    }
+};
+
+template <typename T>
+class IterativeBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "iterative"; }
+
+    bool supports(const SystemProfile& profile) const override {
+        return profile.equations == profile.variables && profile.diagonallyDominant;
+    }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams&) override {
+        return JacobiSolver<T>().solve(sys);
+    }
+};
+
+template <typename T>
+class LeastSquaresBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "qr"; }
+
+    bool supports(const SystemProfile&) const override { return true; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams&) override {
+        return sys->solveLeastSquares();
+    }
+};
+
+#ifdef LINEAR_SOLVER_USE_LAPACK
+template <typename T>
+class LapackBackend : public SolverBackend<T>
+{
+public:
+    string getName() const override { return "lapack"; }
+
+protected:
+    bool solve(LinearSystem<T>* sys, const TuningParams&) override {
+        return LapackSolver<T>().solve(sys);
+    }
+};
+#endif
+
+template <typename T>
+class SolverRegistry
+{
+public:
+    static vector<shared_ptr<SolverBackend<T>>> all() {
+        return {
+            make_shared<NaiveBackend<T>>(),
+            make_shared<ParallelBackend<T>>(),
+            make_shared<BlockedBackend<T>>(),
+            make_shared<CALUBackend<T>>(),
+            make_shared<IterativeBackend<T>>(),
+            make_shared<LeastSquaresBackend<T>>()
+#ifdef LINEAR_SOLVER_USE_LAPACK
+            , make_shared<LapackBackend<T>>()
+#endif
+        };
+    }
+
+    static shared_ptr<SolverBackend<T>> find(const string& name) {
+        for (auto& backend : all()) {
+            if (backend->getName() == name) return backend;
+        }
+        return nullptr;
+    }
+
+    static SystemProfile profile(LinearSystem<T>* sys) {
+        Matrix<T>& A = *sys->getMatrix();
+        int m = sys->getEquationCount();
+        int n = sys->getSize();
+
+        long long nonZeros = 0;
+        int dominantRows = 0;
+
+#pragma omp parallel for schedule(static) reduction(+:nonZeros, dominantRows)
+        for (int i = 0; i < m; i++) {
+            const T* r = A[i];
+            double offDiagonal = 0;
+            for (int j = 0; j < n; j++) {
+                if (r[j] != 0) nonZeros++;
+                if (j != i) offDiagonal += abs(r[j]);
+            }
+            if (i < n && abs(r[i]) > offDiagonal) dominantRows++;
+        }
+
+        SystemProfile p;
+        p.equations = m;
+        p.variables = n;
+        p.density = (m > 0 && n > 0) ? (double)nonZeros / ((double)m * n) : 0;
+        p.diagonallyDominant = (m == n && m > 0 && dominantRows == m);
+        return p;
+    }
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef SPARSEMATRIX_H_
+#define SPARSEMATRIX_H_
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+using namespace std;
+
+// Compressed sparse row storage: row i owns entries [rowStart[i],
+// rowStart[i + 1]) of columns/values, sorted by column with no duplicates
+// once normalize() has run. Products are row-parallel; a row of the result
+// never depends on another, so no two threads write the same entry.
+template <typename T>
+class SparseMatrix
+{
+private:
+    int rows;
+    int cols;
+    vector<int> rowStart;
+    vector<int> columns;
+    vector<T> values;
+
+public:
+    SparseMatrix() : rows(0), cols(0), rowStart(1, 0) {}
+
+    SparseMatrix(int r, int c, vector<int> start, vector<int> cols_, vector<T> vals)
+        : rows(r), cols(c), rowStart(move(start)), columns(move(cols_)), values(move(vals)) {
+    }
+
+    // Sorts every row by column and sums repeated columns, as produced by an
+    // equation that names the same variable twice.
+    void normalize() {
+        vector<int> kept(rows + 1, 0);
+
+#pragma omp parallel for schedule(dynamic, 256)
+        for (int i = 0; i < rows; i++) {
+            int begin = rowStart[i], end = rowStart[i + 1];
+            vector<pair<int, T>> row(end - begin);
+            for (int k = begin; k < end; k++) row[k - begin] = { columns[k], values[k] };
+            sort(row.begin(), row.end(), [](const pair<int, T>& a, const pair<int, T>& b) { return a.first < b.first; });
+
+            int out = begin;
+            for (size_t k = 0; k < row.size(); k++) {
+                if (out > begin && columns[out - 1] == row[k].first) {
+                    values[out - 1] += row[k].second;
+                }
+                else {
+                    columns[out] = row[k].first;
+                    values[out] = row[k].second;
+                    out++;
+                }
+            }
+            kept[i + 1] = out - begin;
+        }
+
+        int out = 0;
+        for (int i = 0; i < rows; i++) {
+            int begin = rowStart[i];
+            for (int k = 0; k < kept[i + 1]; k++) {
+                columns[out + k] = columns[begin + k];
+                values[out + k] = values[begin + k];
+            }
+            rowStart[i] = out;
+            out += kept[i + 1];
+        }
+        rowStart[rows] = out;
+        columns.resize(out);
+        values.resize(out);
+    }
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    size_t getNonZeros() const { return values.size(); }
+
+    const int* getRowStart() const { return rowStart.data(); }
+    const int* getColumns() const { return columns.data(); }
+    const T* getValues() const { return values.data(); }
+    T* getValues() { return values.data(); }
+
+    // y = A x
+    void multiply(const T* x, T* y) const {
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++) {
+            T sum = 0;
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) sum += values[k] * x[columns[k]];
+            y[i] = sum;
+        }
+    }
+
+    // r = b - A x
+    void residual(const T* b, const T* x, T* r) const {
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++) {
+            T sum = b[i];
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) sum -= values[k] * x[columns[k]];
+            r[i] = sum;
+        }
+    }
+
+    // Diagonal entries; 0 where a row stores none.
+    vector<T> diagonal() const {
+        vector<T> d(rows, 0);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                if (columns[k] == i) d[i] = values[k];
+            }
+        }
+        return d;
+    }
+
+    SparseMatrix transpose() const {
+        vector<int> start(cols + 1, 0);
+        for (size_t k = 0; k < columns.size(); k++) start[columns[k] + 1]++;
+        for (int j = 0; j < cols; j++) start[j + 1] += start[j];
+
+        vector<int> next(start.begin(), start.end() - 1);
+        vector<int> tc(columns.size());
+        vector<T> tv(values.size());
+        for (int i = 0; i < rows; i++) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                int at = next[columns[k]]++;
+                tc[at] = i;
+                tv[at] = values[k];
+            }
+        }
+        return SparseMatrix(cols, rows, move(start), move(tc), move(tv));
+    }
+
+    // this * other by Gustavson's row-by-row method in two parallel passes:
+    // the first counts each result row so the second can write into place.
+    // Each thread keeps a dense marker over the result columns.
+    SparseMatrix multiply(const SparseMatrix& other) const {
+        int outCols = other.cols;
+        vector<int> start(rows + 1, 0);
+
+#pragma omp parallel
+        {
+            vector<int> marker(outCols, -1);
+#pragma omp for schedule(dynamic, 256)
+            for (int i = 0; i < rows; i++) {
+                int count = 0;
+                for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                    int mid = columns[k];
+                    for (int l = other.rowStart[mid]; l < other.rowStart[mid + 1]; l++) {
+                        int j = other.columns[l];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            count++;
+                        }
+                    }
+                }
+                start[i + 1] = count;
+            }
+        }
+        for (int i = 0; i < rows; i++) start[i + 1] += start[i];
+
+        vector<int> pc(start[rows]);
+        vector<T> pv(start[rows]);
+
+#pragma omp parallel
+        {
+            vector<int> marker(outCols, -1), slot(outCols);
+#pragma omp for schedule(dynamic, 256)
+            for (int i = 0; i < rows; i++) {
+                int begin = start[i], end = begin;
+                for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                    int mid = columns[k];
+                    T a = values[k];
+                    for (int l = other.rowStart[mid]; l < other.rowStart[mid + 1]; l++) {
+                        int j = other.columns[l];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            slot[j] = end;
+                            pc[end] = j;
+                            pv[end] = a * other.values[l];
+                            end++;
+                        }
+                        else {
+                            pv[slot[j]] += a * other.values[l];
+                        }
+                    }
+                }
+
+                vector<pair<int, T>> row(end - begin);
+                for (int k = begin; k < end; k++) row[k - begin] = { pc[k], pv[k] };
+                sort(row.begin(), row.end(), [](const pair<int, T>& a, const pair<int, T>& b) { return a.first < b.first; });
+                for (int k = begin; k < end; k++) {
+                    pc[k] = row[k - begin].first;
+                    pv[k] = row[k - begin].second;
+                }
+            }
+        }
+        return SparseMatrix(rows, outCols, move(start), move(pc), move(pv));
+    }
+};
+
+#endif
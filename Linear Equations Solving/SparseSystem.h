@@ -0,0 +1,150 @@
+#ifndef SPARSESYSTEM_H_
+#define SPARSESYSTEM_H_
+
+#include "LinearSystem.h"
+#include "Equation.h"
+#include "SymbolTable.h"
+#include "SparseMatrix.h"
+#include "AMGSolver.h"
+#include "SolutionWriter.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Square system kept in sparse form: each equation stores only the terms
+// Equation::parse produced, so memory follows the number of terms instead of
+// n^2. Variables are interned by name as in LinearSystem; the variable count
+// is whatever the equations name, and must equal the equation count once
+// the matrix is assembled. Matrix columns follow natural name order (the
+// order solutions print in), so equation i is paired with the i-th variable
+// and a system written as u1..un keeps its diagonal where it was written.
+template <typename T>
+class SparseSystem
+{
+private:
+    SymbolTable symbols;
+    vector<int> rowStart;
+    vector<int> columns;
+    vector<T> values;
+    vector<T> B;
+    vector<T> result;
+    SparseMatrix<T> A;
+    vector<int> order;
+    bool assembled;
+    InputStatus lastError;
+    string lastErrorMessage;
+
+    bool fail(InputStatus status, string message) {
+        lastError = status;
+        lastErrorMessage = move(message);
+        return false;
+    }
+
+    void appendRow(Equation& eq) {
+        Vector<Term>& terms = eq.getTerms();
+        for (int i = 0; i < terms.getSize(); i++) {
+            columns.push_back(symbols.intern(eq.nameOf(terms[i]), terms[i].nameLength));
+            values.push_back((T)terms[i].value);
+        }
+        rowStart.push_back((int)columns.size());
+        B.push_back((T)eq.getConstant());
+        assembled = false;
+    }
+
+public:
+    SparseSystem() : rowStart(1, 0), assembled(false), lastError(InputStatus::Ok) {}
+
+    bool addEquation(const string& input) {
+        Equation eq;
+        if (eq.parse(input) != ParseStatus::Ok) return fail(InputStatus::ParseError, eq.errorMessage());
+        appendRow(eq);
+        return true;
+    }
+
+    // Parses the lines in parallel, then appends them in input order so
+    // column ids match what addEquation would have assigned. Returns how
+    // many equations were added.
+    int addEquations(const vector<string>& lines) {
+        int count = (int)lines.size();
+        vector<Equation> parsed(count);
+        vector<char> ok(count);
+
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < count; i++) ok[i] = parsed[i].parse(lines[i]) == ParseStatus::Ok;
+
+        int added = 0;
+        for (int i = 0; i < count; i++) {
+            if (!ok[i]) {
+                fail(InputStatus::ParseError, "Line " + to_string(i + 1) + ": " + parsed[i].errorMessage());
+                continue;
+            }
+            appendRow(parsed[i]);
+            added++;
+        }
+        return added;
+    }
+
+    InputStatus getLastError() const { return lastError; }
+    const string& getLastErrorMessage() const { return lastErrorMessage; }
+
+    int getEquationCount() const { return (int)B.size(); }
+    int getSize() const { return symbols.size(); }
+    const SymbolTable& getSymbols() const { return symbols; }
+
+    // Builds the CSR matrix, merging repeated names within a row.
+    bool assemble() {
+        if (assembled) return true;
+        int m = getEquationCount(), n = getSize();
+        if (m != n) {
+            return fail(InputStatus::NotSquare,
+                "The sparse system has " + to_string(m) + " equations for " + to_string(n) + " variables.");
+        }
+
+        order = symbols.naturalOrder();
+        vector<int> rankOf(n);
+        for (int k = 0; k < n; k++) rankOf[order[k]] = k;
+
+        vector<int> ranked(columns.size());
+#pragma omp parallel for schedule(static)
+        for (long long k = 0; k < (long long)columns.size(); k++) ranked[k] = rankOf[columns[k]];
+
+        A = SparseMatrix<T>(m, n, rowStart, move(ranked), values);
+        A.normalize();
+        assembled = true;
+        return true;
+    }
+
+    const SparseMatrix<T>& getMatrix() const { return A; }
+
+    // Sets up the hierarchy and solves from a zero guess; the setup and
+    // solve costs are reported separately by the solver.
+    bool solve(AMGSolver<T>& amg) {
+        if (!assemble()) return false;
+        if (!amg.setup(A)) {
+            return fail(InputStatus::ZeroDiagonal, "Every equation needs a nonzero coefficient on its own variable.");
+        }
+        vector<T> x(getSize(), 0);
+        bool converged = amg.solve(B.data(), x.data());
+
+        result.resize(getSize());
+        for (int k = 0; k < getSize(); k++) result[order[k]] = x[k];
+        return converged;
+    }
+
+    // Values indexed by variable id (order of first appearance).
+    const vector<T>& getResult() const { return result; }
+
+    void printSolution() {
+        SolutionWriter<T>::writeStdoutText("\n--- Solution ---\n");
+        SolutionWriter<T>::writeStdout(result.data(), getSize(), SolutionFormat::Text, 6, 1, &symbols, order.data());
+        SolutionWriter<T>::writeStdoutText("----------------\n\n");
+    }
+
+    bool exportSolution(const string& path, SolutionFormat format) {
+        return SolutionWriter<T>::writeFile(path, result.data(), getSize(), format, 0, &symbols, order.data());
+    }
+};
+
+#endif
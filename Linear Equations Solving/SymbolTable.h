@@ -0,0 +1,141 @@
+#ifndef SYMBOLTABLE_H_
+#define SYMBOLTABLE_H_
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Interns variable names into dense column ids, assigned in order of first
+// appearance. Names live back to back in one character pool; lookups go
+// through a flat open-addressing table (FNV-1a, linear probing, load kept
+// at or below one half) holding ids, with the full hash cached per id so
+// probes rarely touch the pool.
+class SymbolTable
+{
+private:
+    vector<char> pool;
+    vector<size_t> offsets;
+    vector<uint64_t> hashes;
+    vector<int> slots;
+    size_t mask;
+
+    static uint64_t hash(const char* s, size_t len) {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < len; i++) {
+            h ^= (unsigned char)s[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // Slot holding the name, or the empty slot where it would go.
+    size_t probe(const char* s, size_t len, uint64_t h) const {
+        size_t i = (size_t)h & mask;
+        while (slots[i] >= 0) {
+            int id = slots[i];
+            if (hashes[id] == h && nameLength(id) == len && memcmp(nameData(id), s, len) == 0) break;
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void rehash(size_t capacity) {
+        slots.assign(capacity, -1);
+        mask = capacity - 1;
+        for (int id = 0; id < size(); id++) {
+            size_t i = (size_t)hashes[id] & mask;
+            while (slots[i] >= 0) i = (i + 1) & mask;
+            slots[i] = id;
+        }
+    }
+
+public:
+    SymbolTable() : offsets(1, 0), slots(64, -1), mask(63) {}
+
+    int size() const { return (int)hashes.size(); }
+
+    int find(const char* s, size_t len) const {
+        return slots[probe(s, len, hash(s, len))];
+    }
+
+    int find(const string& name) const { return find(name.data(), name.size()); }
+
+    int intern(const char* s, size_t len) {
+        uint64_t h = hash(s, len);
+        size_t slot = probe(s, len, h);
+        if (slots[slot] >= 0) return slots[slot];
+
+        if ((hashes.size() + 1) * 2 > slots.size()) {
+            rehash(slots.size() * 2);
+            slot = probe(s, len, h);
+        }
+
+        int id = size();
+        pool.insert(pool.end(), s, s + len);
+        offsets.push_back(pool.size());
+        hashes.push_back(h);
+        slots[slot] = id;
+        return id;
+    }
+
+    // Forgets every name from id 'count' on; used to roll back an equation
+    // that turned out to introduce too many variables.
+    void truncate(int count) {
+        if (count >= size()) return;
+        pool.resize(offsets[count]);
+        offsets.resize(count + 1);
+        hashes.resize(count);
+        rehash(slots.size());
+    }
+
+    const char* nameData(int id) const { return pool.data() + offsets[id]; }
+    size_t nameLength(int id) const { return offsets[id + 1] - offsets[id]; }
+    string name(int id) const { return string(nameData(id), nameLength(id)); }
+
+    // Natural order: runs of digits compare by numeric value, so x2 < x10
+    // and flow_a9 < flow_a12. Ties fall back to plain byte order.
+    static bool naturalLess(const char* a, size_t la, const char* b, size_t lb) {
+        size_t i = 0, j = 0;
+        while (i < la && j < lb) {
+            bool da = a[i] >= '0' && a[i] <= '9';
+            bool db = b[j] >= '0' && b[j] <= '9';
+
+            if (da && db) {
+                while (i < la && a[i] == '0') i++;
+                while (j < lb && b[j] == '0') j++;
+                size_t si = i, sj = j;
+                while (i < la && a[i] >= '0' && a[i] <= '9') i++;
+                while (j < lb && b[j] >= '0' && b[j] <= '9') j++;
+
+                if (i - si != j - sj) return i - si < j - sj;
+                int c = memcmp(a + si, b + sj, i - si);
+                if (c != 0) return c < 0;
+                continue;
+            }
+
+            if (a[i] != b[j]) return (unsigned char)a[i] < (unsigned char)b[j];
+            i++;
+            j++;
+        }
+        if ((i < la) != (j < lb)) return j < lb;
+
+        int c = memcmp(a, b, min(la, lb));
+        return c != 0 ? c < 0 : la < lb;
+    }
+
+    // Ids sorted by natural name order.
+    vector<int> naturalOrder() const {
+        vector<int> order(size());
+        for (int id = 0; id < size(); id++) order[id] = id;
+        sort(order.begin(), order.end(), [this](int x, int y) {
+            return naturalLess(nameData(x), nameLength(x), nameData(y), nameLength(y));
+        });
+        return order;
+    }
+};
+
+#endif
@@ -0,0 +1,1031 @@
+#ifndef TESTSUITE_H_
+#define TESTSUITE_H_
+
+#include "LinearSystem.h"
+#include "SolverBackend.h"
+#include "ModularSolver.h"
+#include "SolutionWriter.h"
+#include "SparseSystem.h"
+#include "AsyncSolver.h"
+#include "ConcurrentBenchmark.h"
+#include "SolutionVerifier.h"
+#include "SolverAutotuner.h"
+#include "EquationGenerator.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <charconv>
+#include <functional>
+#include <thread>
+#include <cmath>
+#include <fcntl.h>
+#include <omp.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+enum class MatrixStructure { Dense, DiagonallyDominant, UpperTriangular, Symmetric, Permutation, Tridiagonal };
+
+inline const char* matrixStructureName(MatrixStructure s) {
+    switch (s) {
+    case MatrixStructure::DiagonallyDominant: return "diagonally-dominant";
+    case MatrixStructure::UpperTriangular: return "upper-triangular";
+    case MatrixStructure::Symmetric: return "symmetric";
+    case MatrixStructure::Permutation: return "permutation";
+    case MatrixStructure::Tridiagonal: return "tridiagonal";
+    default: return "dense";
+    }
+}
+
+// Headless checks run by `LinearSolver --test <group>` and registered with
+// CTest. Every group counts passed and failed checks and prints one line per
+// failure; main() turns a failure into a non-zero exit code.
+//   cases   - the original ten interactive cases, now with expected results
+//   solvers - every backend, pivot strategy and solve path against known
+//             solutions and backward-error bounds over sizes and structures
+//   fuzz    - Equation::parse on random, generated and mutated input
+//   perf    - timings compared with a baseline file; a benchmark more than
+//             the threshold percent slower fails
+class TestSuite
+{
+private:
+    int passed;
+    int failed;
+    bool verbose;
+
+    void check(bool ok, const string& what) {
+        if (ok) {
+            passed++;
+            return;
+        }
+        failed++;
+        cout << "FAIL: " << what << endl;
+    }
+
+    static int availableThreads() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    // Integer entries so every solver sees exactly the same system and
+    // b = A * xTrue is exact in double.
+    static void fillMatrix(vector<double>& A, int n, MatrixStructure s, mt19937& rng) {
+        uniform_int_distribution<int> dist(-9, 9);
+        A.assign((size_t)n * n, 0.0);
+
+        switch (s) {
+        case MatrixStructure::Dense:
+            for (double& a : A) a = dist(rng);
+            for (int i = 0; i < n; i++) A[(size_t)i * n + i] += (A[(size_t)i * n + i] >= 0 ? 1 : -1);
+            break;
+        case MatrixStructure::DiagonallyDominant:
+            for (int i = 0; i < n; i++) {
+                double off = 0;
+                for (int j = 0; j < n; j++) {
+                    if (j == i) continue;
+                    A[(size_t)i * n + j] = dist(rng);
+                    off += fabs(A[(size_t)i * n + j]);
+                }
+                A[(size_t)i * n + i] = off + 1 + (dist(rng) + 9);
+            }
+            break;
+        case MatrixStructure::UpperTriangular:
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) A[(size_t)i * n + j] = dist(rng);
+                A[(size_t)i * n + i] = 10 * n + (dist(rng) + 10);
+            }
+            break;
+        case MatrixStructure::Symmetric:
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    double v = dist(rng);
+                    A[(size_t)i * n + j] = v;
+                    A[(size_t)j * n + i] = v;
+                }
+                A[(size_t)i * n + i] = 9 * n + 1;
+            }
+            break;
+        case MatrixStructure::Permutation: {
+            vector<int> p(n);
+            for (int i = 0; i < n; i++) p[i] = i;
+            shuffle(p.begin(), p.end(), rng);
+            for (int i = 0; i < n; i++) A[(size_t)i * n + p[i]] = (dist(rng) >= 0 ? 1 : -1) * (1 + (i % 5));
+            break;
+        }
+        case MatrixStructure::Tridiagonal:
+            for (int i = 0; i < n; i++) {
+                if (i > 0) A[(size_t)i * n + i - 1] = -1;
+                if (i + 1 < n) A[(size_t)i * n + i + 1] = -1;
+                A[(size_t)i * n + i] = 4;
+            }
+            break;
+        }
+    }
+
+    static void load(LinearSystem<double>& sys, const vector<double>& A, const vector<double>& b) {
+        Matrix<double>& M = *sys.getMatrix();
+        Vector<double>& B = *sys.getConstants();
+        int m = sys.getEquationCount();
+        int n = sys.getSize();
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) M[i][j] = A[(size_t)i * n + j];
+            B[i] = b[i];
+        }
+    }
+
+    static vector<double> multiply(const vector<double>& A, const vector<double>& x, int m, int n) {
+        vector<double> b(m, 0.0);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) b[i] += A[(size_t)i * n + j] * x[j];
+        }
+        return b;
+    }
+
+    // ||b - Ax||_inf / (||A||_inf ||x||_inf + ||b||_inf)
+    static double backwardError(const vector<double>& A, const vector<double>& b, const double* x, int m, int n) {
+        double r = 0, normA = 0, normX = 0, normB = 0;
+        for (int j = 0; j < n; j++) normX = max(normX, fabs(x[j]));
+        for (int i = 0; i < m; i++) {
+            double s = b[i], row = 0;
+            for (int j = 0; j < n; j++) {
+                s -= A[(size_t)i * n + j] * x[j];
+                row += fabs(A[(size_t)i * n + j]);
+            }
+            r = max(r, fabs(s));
+            normA = max(normA, row);
+            normB = max(normB, fabs(b[i]));
+        }
+        double scale = normA * normX + normB;
+        return scale > 0 ? r / scale : r;
+    }
+
+    static double forwardError(const double* x, const vector<double>& xTrue) {
+        double err = 0, norm = 0;
+        for (size_t j = 0; j < xTrue.size(); j++) {
+            err = max(err, fabs(x[j] - xTrue[j]));
+            norm = max(norm, fabs(xTrue[j]));
+        }
+        return norm > 0 ? err / norm : err;
+    }
+
+    static vector<double> randomSolution(int n, mt19937& rng) {
+        uniform_int_distribution<int> dist(-10, 10);
+        vector<double> x(n);
+        for (double& v : x) v = dist(rng);
+        return x;
+    }
+
+    static string numberText(double v) {
+        char buf[512];
+        char* end = to_chars(buf, buf + sizeof(buf), v, chars_format::fixed).ptr;
+        return string(buf, end);
+    }
+
+    // Writes parsed terms back out as "c1name1 + c2name2 ... = constant";
+    // parsing that again must give the same terms and constant bit for bit.
+    static string canonical(Equation& eq) {
+        string out;
+        Vector<Term>& terms = eq.getTerms();
+        for (int i = 0; i < terms.getSize(); i++) {
+            double v = terms[i].value;
+            out += (signbit(v) ? "-" : "+") + numberText(fabs(v));
+            out.append(eq.nameOf(terms[i]), terms[i].nameLength);
+        }
+        return out + "=" + numberText(eq.getConstant());
+    }
+
+    static bool sameParse(Equation& a, Equation& b) {
+        Vector<Term>& ta = a.getTerms();
+        Vector<Term>& tb = b.getTerms();
+        if (ta.getSize() != tb.getSize()) return false;
+        if (a.getConstant() != b.getConstant()) return false;
+        for (int i = 0; i < ta.getSize(); i++) {
+            if (ta[i].value != tb[i].value || ta[i].nameLength != tb[i].nameLength) return false;
+            if (string(a.nameOf(ta[i]), ta[i].nameLength) != string(b.nameOf(tb[i]), tb[i].nameLength)) return false;
+        }
+        return true;
+    }
+
+    struct Case {
+        string desc;
+        int vars;
+        vector<string> equations;
+        bool parses;
+        bool solvable;
+        vector<double> expected;
+    };
+
+    void checkBackends(int n, MatrixStructure s, unsigned seed) {
+        mt19937 rng(seed);
+        vector<double> A;
+        fillMatrix(A, n, s, rng);
+        vector<double> xTrue = randomSolution(n, rng);
+        vector<double> b = multiply(A, xTrue, n, n);
+        bool wellConditioned = (s != MatrixStructure::Dense);
+        TuningParams params = { 16, 0, true };
+
+        for (auto& backend : SolverRegistry<double>::all()) {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            if (!backend->supports(SolverRegistry<double>::profile(&sys))) continue;
+
+            string what = backend->getName() + " n=" + to_string(n) + " " + matrixStructureName(s);
+            bool ok = backend->run(&sys, params);
+            check(ok, what + " reports failure");
+            if (!ok) continue;
+
+            const double* x = &(*sys.getResult())[0];
+            double be = backwardError(A, b, x, n, n);
+            check(be <= 1e-12, what + " backward error " + to_string(be));
+            if (wellConditioned) check(forwardError(x, xTrue) <= 1e-9, what + " forward error");
+        }
+
+        for (PivotStrategy strategy : { PivotStrategy::Partial, PivotStrategy::Rook, PivotStrategy::Complete }) {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            sys.setPivotStrategy(strategy);
+            string what = string("solve/") + pivotStrategyName(strategy) + " n=" + to_string(n) + " " + matrixStructureName(s);
+            bool ok = sys.solve();
+            check(ok, what + " reports failure");
+            if (!ok) continue;
+            check(backwardError(A, b, &(*sys.getResult())[0], n, n) <= 1e-12, what + " backward error");
+            check(sys.getGrowthFactor() > 0, what + " growth factor not reported");
+        }
+    }
+
+    void checkMultipleRhs(int n, unsigned seed) {
+        mt19937 rng(seed);
+        vector<double> A;
+        fillMatrix(A, n, MatrixStructure::Dense, rng);
+        const int columns = 3;
+        vector<vector<double>> xs, bs;
+        for (int c = 0; c < columns; c++) {
+            xs.push_back(randomSolution(n, rng));
+            bs.push_back(multiply(A, xs.back(), n, n));
+        }
+
+        // Entered as equations: constant columns are only taken once every
+        // equation is in.
+        LinearSystem<double> sys(n);
+        for (int i = 0; i < n; i++) {
+            string eq;
+            for (int j = 0; j < n; j++) {
+                double a = A[(size_t)i * n + j];
+                eq += (signbit(a) ? "-" : "+") + numberText(fabs(a)) + "x" + to_string(j + 1);
+            }
+            check(sys.addEquation(eq + "=" + numberText(bs[0][i])), "equation rejected n=" + to_string(n));
+        }
+        for (int c = 1; c < columns; c++) {
+            string line;
+            for (double v : bs[c]) line += numberText(v) + " ";
+            check(sys.addConstantColumn(line), "rhs column rejected n=" + to_string(n));
+        }
+        bool ok = sys.solveAll() && sys.getConstantBlock();
+        check(ok, "solve_all reports failure n=" + to_string(n));
+        if (!ok) return;
+
+        const double* X = sys.getConstantBlock();
+        for (int c = 0; c < columns; c++) {
+            vector<double> x(n);
+            for (int i = 0; i < n; i++) x[i] = X[(size_t)i * columns + c];
+            check(backwardError(A, bs[c], x.data(), n, n) <= 1e-12,
+                "solve_all column " + to_string(c + 1) + " n=" + to_string(n));
+        }
+    }
+
+    // Once a solver has touched A, constant columns for the coefficients as
+    // entered must be refused, the determinant must keep the sign of the
+    // row swaps, and a factorization that fails part way must leave
+    // equations a later solve can still use.
+    void checkReducedState() {
+        for (auto& backend : SolverRegistry<double>::all()) {
+            if (backend->getName() == "iterative") continue;
+            LinearSystem<double> sys(2);
+            sys.addEquation("x1 + 2x2 = 3");
+            sys.addEquation("3x1 + x2 = 4");
+            TuningParams params = { 32, 0, true };
+            backend->run(&sys, params);
+            check(!sys.addConstantColumn("5 5") && sys.getLastError() == InputStatus::AlreadyReduced,
+                backend->getName() + " left the system open to new constant columns");
+            check(sys.hasDeterminant() && fabs(sys.getLastDeterminant() + 5) <= 1e-12,
+                backend->getName() + " determinant " + to_string(sys.getLastDeterminant()));
+            const double* x = &(*sys.getResult())[0];
+            check(sys.solveLeastSquares() && fabs(x[0] - 1) <= 1e-12 && fabs(x[1] - 1) <= 1e-12,
+                backend->getName() + " left a different system in A and B");
+        }
+
+        LinearSystem<double> combined(2);
+        combined.addEquation("x1 + x2 = 2");
+        combined.addEquation("x1 - x2 = 0");
+        check(combined.addConstantColumn("3 1"), "constant column before row operations");
+        combined.combineRows(1, 0, 1);
+        check(!combined.addConstantColumn("5 5"), "constant column accepted after a row operation");
+        check(combined.solveAll() && combined.getConstantBlock()[1] == 2 && combined.getConstantBlock()[3] == 1,
+            "row operation skipped the streamed constant column");
+        combined.combineRows(1, 0, 2);
+        check(combined.hasDeterminant() && combined.getLastDeterminant() == -2,
+            "row operation between rows dropped the determinant");
+        combined.combineRows(1, 1, 1);
+        check(combined.hasDeterminant() && combined.getLastDeterminant() == -4,
+            "doubling a row kept the old determinant");
+
+        const int n = 150;
+        mt19937 rng(n);
+        vector<double> A;
+        fillMatrix(A, n, MatrixStructure::Dense, rng);
+        for (int j = 0; j < n; j++) A[(size_t)(n - 1) * n + j] = A[j] + A[(size_t)n + j];
+        vector<double> b = multiply(A, randomSolution(n, rng), n, n);
+        for (const char* name : { "naive", "parallel", "blocked", "calu" }) {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            TuningParams params = { 32, 0, true };
+            check(!SolverRegistry<double>::find(name)->run(&sys, params), string(name) + " solved a singular system");
+            check(sys.solveLeastSquares() && backwardError(A, b, &(*sys.getResult())[0], n, n) <= 1e-10,
+                string(name) + " failed factorization changed the system");
+        }
+    }
+
+    void checkLeastSquares(int n, unsigned seed) {
+        mt19937 rng(seed);
+        uniform_int_distribution<int> dist(-9, 9);
+
+        // Overdetermined but consistent: the exact solution is recovered.
+        int m = n + 5;
+        vector<double> A((size_t)m * n);
+        for (double& a : A) a = dist(rng);
+        vector<double> xTrue = randomSolution(n, rng);
+        vector<double> b = multiply(A, xTrue, m, n);
+        {
+            LinearSystem<double> sys(m, n);
+            load(sys, A, b);
+            bool ok = sys.solveLeastSquares();
+            check(ok && sys.getRank() == n, "lstsq overdetermined rank n=" + to_string(n));
+            if (ok) check(forwardError(&(*sys.getResult())[0], xTrue) <= 1e-9, "lstsq overdetermined n=" + to_string(n));
+
+            // What is left in A and B is the same system.
+            ok = sys.solveLeastSquares();
+            if (ok) check(forwardError(&(*sys.getResult())[0], xTrue) <= 1e-9, "lstsq left a different system n=" + to_string(n));
+        }
+
+        // Underdetermined: any solution fits, the minimum-norm one is no
+        // longer than the one b was built from.
+        if (n > 3) {
+            m = n - 3;
+            A.assign((size_t)m * n, 0.0);
+            for (double& a : A) a = dist(rng);
+            b = multiply(A, xTrue, m, n);
+            LinearSystem<double> sys(m, n);
+            load(sys, A, b);
+            bool ok = sys.solveLeastSquares();
+            check(ok && sys.getRank() == m, "lstsq underdetermined rank n=" + to_string(n));
+            if (ok) {
+                const double* x = &(*sys.getResult())[0];
+                double nx = 0, nt = 0;
+                for (int j = 0; j < n; j++) {
+                    nx += x[j] * x[j];
+                    nt += xTrue[j] * xTrue[j];
+                }
+                check(backwardError(A, b, x, m, n) <= 1e-12, "lstsq underdetermined residual n=" + to_string(n));
+                check(nx <= nt * (1 + 1e-12), "lstsq underdetermined not minimum norm n=" + to_string(n));
+
+                vector<double> first(x, x + n);
+                ok = sys.solveLeastSquares();
+                check(ok && backwardError(A, b, x, m, n) <= 1e-12 && forwardError(x, first) <= 1e-9,
+                    "lstsq left a different underdetermined system n=" + to_string(n));
+            }
+        }
+    }
+
+    void checkExact(int n, unsigned seed) {
+        mt19937 rng(seed);
+        vector<double> A;
+        fillMatrix(A, n, MatrixStructure::Dense, rng);
+        vector<double> xTrue = randomSolution(n, rng);
+        vector<double> b = multiply(A, xTrue, n, n);
+
+        LinearSystem<double> sys(n);
+        load(sys, A, b);
+        ModularSolver<double> exact;
+        ExactStatus status = exact.solve(&sys);
+        check(status == ExactStatus::Solved, "solve_exact n=" + to_string(n) + ": " + exactStatusMessage(status));
+        if (status == ExactStatus::Solved) {
+            bool same = true;
+            for (int j = 0; j < n; j++) same = same && exact.valueString(j) == to_string((long long)xTrue[j]);
+            check(same, "solve_exact wrong values n=" + to_string(n));
+        }
+
+        if (n == 1) {
+            LinearSystem<double> large(1), tooLarge(1);
+            large.addEquation("x1 = 1234567890.5");
+            check(exact.solve(&large) == ExactStatus::Solved && exact.valueString(0) == "2469135781/2",
+                "solve_exact rounded a large decimal");
+            tooLarge.addEquation("x1 = 1234567890123456.5");
+            check(exact.solve(&tooLarge) == ExactStatus::NotRational, "solve_exact accepted an unscalable decimal");
+        }
+
+        if (n > 1) {
+            for (int j = 0; j < n; j++) A[(size_t)(n - 1) * n + j] = 2 * A[j];
+            b[n - 1] = 2 * b[0];
+            LinearSystem<double> singular(n);
+            load(singular, A, b);
+            check(exact.solve(&singular) == ExactStatus::Singular, "solve_exact missed singular n=" + to_string(n));
+        }
+    }
+
+    // Futures, progress, cancellation mid-solve and deadlines. A stopped
+    // elimination must leave an equivalent system that a second solve
+    // finishes correctly.
+    void checkAsync() {
+        const int n = 300;
+        mt19937 rng(n);
+        vector<double> A;
+        fillMatrix(A, n, MatrixStructure::Dense, rng);
+        vector<double> b = multiply(A, randomSolution(n, rng), n, n);
+
+        {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            auto control = make_shared<SolveControl>();
+            int reports = 0, lastStep = -1;
+            bool ordered = true;
+            control->setProgressCallback([&](const SolveProgress& p) {
+                reports++;
+                ordered = ordered && p.step > lastStep && p.total == n;
+                lastStep = p.step;
+            }, chrono::milliseconds(0));
+
+            SolveStatus status = AsyncSolver<double>::solve(&sys, control).get();
+            check(status == SolveStatus::Solved, string("async solve: ") + solveStatusMessage(status));
+            check(reports == n && ordered, "async solve progress: " + to_string(reports) + " reports");
+            check(backwardError(A, b, &(*sys.getResult())[0], n, n) <= 1e-12, "async solve backward error");
+            check(sys.getSolveControl() == nullptr, "control left attached");
+        }
+
+        for (const char* name : { "naive", "parallel", "blocked", "calu" }) {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            auto control = make_shared<SolveControl>();
+            control->setProgressCallback([&](const SolveProgress& p) {
+                if (p.step >= n / 2) control->cancel();
+            }, chrono::milliseconds(0));
+
+            TuningParams params = { 32, 0, true };
+            SolveStatus status = AsyncSolver<double>::run(SolverRegistry<double>::find(name), &sys, params, control).get();
+            check(status == SolveStatus::Cancelled, string(name) + " mid-solve cancel: " + solveStatusMessage(status));
+
+            check(sys.solve(), string(name) + " solve after cancel");
+            check(backwardError(A, b, &(*sys.getResult())[0], n, n) <= 1e-12,
+                string(name) + " cancelled elimination changed the system");
+        }
+
+        {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            auto control = make_shared<SolveControl>();
+            control->setDeadline(chrono::steady_clock::now() - chrono::seconds(1));
+            SolveStatus status = AsyncSolver<double>::solve(&sys, control).get();
+            check(status == SolveStatus::DeadlineExceeded, string("expired deadline: ") + solveStatusMessage(status));
+        }
+
+        {
+            SparseSystem<double> sparse = laplacian(64);
+            SolveControl control;
+            control.cancel();
+            AMGSolver<double> amg;
+            amg.setSolveControl(&control);
+            check(!sparse.solve(amg) && amg.getIterations() == 0, "amg ignored cancellation");
+        }
+    }
+
+    // Independent systems solved on concurrent threads must give bit-for-bit
+    // the answers they give one at a time, for generated and parsed input.
+    void checkConcurrent() {
+        const int n = 120, workers = 4;
+        for (const char* name : { "parallel", "blocked" }) {
+            vector<vector<double>> serial(workers), concurrent(workers);
+            bool solved = true;
+            for (int w = 0; w < workers; w++) solved = ConcurrentBenchmark<double>::solveOne(n, w, name, serial[w]) && solved;
+            check(solved, string(name) + " serial generated solves");
+
+            vector<char> ok(workers, 0);
+            vector<thread> pool;
+            for (int w = 0; w < workers; w++) {
+                pool.emplace_back([&, w]() {
+#ifdef _OPENMP
+                    omp_set_num_threads(1);
+#endif
+                    ok[w] = ConcurrentBenchmark<double>::solveOne(n, w, name, concurrent[w]);
+                });
+            }
+            for (thread& t : pool) t.join();
+
+            bool same = true;
+            for (int w = 0; w < workers; w++) same = same && ok[w] && concurrent[w] == serial[w];
+            check(same, string(name) + " concurrent solves differ from serial");
+        }
+
+        EquationGenerator first(7), second(7);
+        check(first.generateMixedEquation(50) == second.generateMixedEquation(50), "seeded generators differ");
+        check(ConcurrentBenchmark<double>::timeWorkers(2, 40, 2, "parallel") > 0, "concurrent benchmark run");
+    }
+
+    // The dot2 residual has to survive cancellation that wipes out a plain
+    // sum, and the verification pass has to agree with the dense backward
+    // error while holding neither A nor a copy of it.
+    void checkVerification() {
+        vector<double> a = { 1e16, 1, -1e16 }, ones(20, 1.0);
+        check(SolutionVerifier<double>::residual(a.data(), ones.data(), 3, 0) == 1, "dot2 lost the cancelled term");
+
+        vector<double> wide;
+        for (int k = 0; k < 5; k++) {
+            double big = ldexp(1.0, 60 + k);
+            wide.insert(wide.end(), { big, 0.5, -big, 0.5 });
+        }
+        check(SolutionVerifier<double>::residual(wide.data(), ones.data(), 20, 0) == 5, "dot2 across SIMD lanes");
+
+        const int n = 80;
+        EquationGenerator gen(11);
+        vector<string> lines;
+        for (int i = 0; i < n; i++) lines.push_back(gen.generateMixedEquation(n));
+
+        LinearSystem<double> sys(n), copy(n);
+        sys.setVerification(true);
+        sys.addEquations(lines);
+        copy.addEquations(lines);
+        check(sys.solve() && sys.verify(), "verify after solve");
+
+        vector<double> A((size_t)n * n), b(n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) A[(size_t)i * n + j] = (*copy.getMatrix())[i][j];
+            b[i] = (*copy.getConstants())[i];
+        }
+        const VerificationReport& report = sys.getVerification();
+        double dense = backwardError(A, b, &(*sys.getResult())[0], n, n);
+        check(report.rows == n && report.skipped == 0, "verified rows " + to_string(report.rows));
+        check(report.backwardError <= 1e-14 && fabs(report.backwardError - dense) <= 1e-15,
+            "backward error " + to_string(report.backwardError) + " vs dense " + to_string(dense));
+
+        (*sys.getResult())[0] += 1e-3;
+        sys.verify();
+        check(sys.getVerification().backwardError > 1e-8, "perturbed solution passed verification");
+
+        SolutionVerifier<double> unknown(&(*sys.getResult())[0], n, &sys.getSymbols());
+        check(unknown.addEquations({ lines[0], "x1 + nope = 2", "x1 = = 2" }) == 1 && unknown.report().skipped == 2,
+            "unknown names and bad lines not skipped");
+
+        for (const char* name : { "parallel", "calu" }) {
+            LinearSystem<double> random(n);
+            mt19937 rng(3);
+            SolverAutotuner<double>::fillRandom(random, rng);
+            TuningParams params = { 32, 0, true };
+            check(SolverRegistry<double>::find(name)->run(&random, params), string(name) + " random solve");
+            mt19937 replay(3);
+            VerificationReport r = SolverAutotuner<double>::verifyRandom(&(*random.getResult())[0], n, replay);
+            check(r.rows == n && r.backwardError <= 1e-14, string(name) + " replayed backward error " + to_string(r.backwardError));
+        }
+    }
+
+    void checkNaming() {
+        vector<string> lines = { "flow_a12 + 2y = 3", "x10 - x2 = 1", "y + _t = 0", "x2 + flow_a9 = 4", "_t = 1", "x10 = 2" };
+        LinearSystem<double> one(6), batch(6);
+        for (const string& l : lines) one.addEquation(l);
+        check(batch.addEquations(lines) == 6, "addEquations count");
+
+        bool same = one.getSymbols().size() == batch.getSymbols().size();
+        for (int i = 0; i < 6 && same; i++) {
+            for (int j = 0; j < 6; j++) same = same && (*one.getMatrix())[i][j] == (*batch.getMatrix())[i][j];
+        }
+        check(same, "addEquations differs from addEquation");
+
+        const vector<int>& order = batch.getVariableOrder();
+        string names;
+        for (int col : order) names += batch.variableName(col) + " ";
+        check(names == "_t flow_a9 flow_a12 x2 x10 y ", "natural order: " + names);
+
+        LinearSystem<double> tooMany(2);
+        check(tooMany.addEquation("a + b = 1"), "two names in a 2-variable system");
+        check(!tooMany.addEquation("a + c = 1"), "third name accepted in a 2-variable system");
+        check(tooMany.getLastError() == InputStatus::TooManyVariables, "wrong status for a third name");
+        check(tooMany.getSymbols().size() == 2 && tooMany.findVariable("c") < 0, "rejected name kept");
+    }
+
+    // Tournament pivoting may pick different rows than partial pivoting, but
+    // its growth factor has to stay in the same range on random matrices.
+    void checkTournamentGrowth() {
+        for (int n : { 96, 257 }) {
+            mt19937 rng(n);
+            vector<double> A;
+            fillMatrix(A, n, MatrixStructure::Dense, rng);
+            vector<double> b = multiply(A, randomSolution(n, rng), n, n);
+            TuningParams params = { 32, 0, true };
+
+            double growth[2];
+            const char* names[2] = { "blocked", "calu" };
+            for (int k = 0; k < 2; k++) {
+                LinearSystem<double> sys(n);
+                load(sys, A, b);
+                auto backend = SolverRegistry<double>::find(names[k]);
+                backend->run(&sys, params);
+                growth[k] = backend->getGrowthFactor();
+            }
+            check(growth[0] > 0 && growth[1] > 0 && growth[1] <= 4 * growth[0],
+                "calu growth " + to_string(growth[1]) + " vs partial " + to_string(growth[0]) + " n=" + to_string(n));
+        }
+    }
+
+    // Every cycle / smoother / mode on a Laplacian big enough for a real
+    // hierarchy, against the dense solve of the same equations.
+    void checkMultigrid() {
+        const int grid = 30;
+        EquationGenerator gen;
+        vector<string> lines;
+        for (int i = 0; i < grid * grid; i++) lines.push_back(gen.generateLaplacianEquation(i, grid));
+
+        SparseSystem<double> sparse;
+        check(sparse.addEquations(lines) == grid * grid, "sparse addEquations count");
+        LinearSystem<double> dense(grid * grid);
+        dense.addEquations(lines);
+        check(dense.solve(), "dense Laplacian solve");
+
+        for (AMGCycle c : { AMGCycle::V, AMGCycle::W }) {
+            for (AMGSmoother s : { AMGSmoother::Chebyshev, AMGSmoother::GaussSeidel }) {
+                for (bool pcg : { false, true }) {
+                    string what = string("amg ") + amgCycleName(c) + " " + amgSmootherName(s) + (pcg ? " pcg" : " standalone");
+                    AMGSolver<double> amg(c, s, pcg);
+                    bool ok = sparse.solve(amg);
+                    check(ok && amg.getLevelCount() > 1, what + " did not converge");
+                    check(amg.getIterations() <= 40, what + " took " + to_string(amg.getIterations()) + " iterations");
+
+                    double err = 0;
+                    for (int i = 0; i < grid * grid && ok; i++) {
+                        string name = "u" + to_string(i + 1);
+                        double d = (*dense.getResult())[dense.findVariable(name)];
+                        err = max(err, fabs(sparse.getResult()[sparse.getSymbols().find(name)] - d));
+                    }
+                    check(err <= 1e-6, what + " differs from the dense solve by " + to_string(err));
+                }
+            }
+        }
+
+        SparseSystem<double> noDiagonal;
+        noDiagonal.addEquation("a + b = 1");
+        noDiagonal.addEquation("a = 2");
+        AMGSolver<double> amg;
+        check(noDiagonal.solve(amg) == false && noDiagonal.getLastError() == InputStatus::ZeroDiagonal,
+            "amg accepted a zero diagonal");
+    }
+
+    template <typename F>
+    static double bestOf(int reps, F run) {
+        double best = -1;
+        for (int r = 0; r < reps; r++) {
+            double t = run();
+            if (best < 0 || t < best) best = t;
+        }
+        return best;
+    }
+
+    template <typename F>
+    static double timed(F body) {
+        auto start = chrono::high_resolution_clock::now();
+        body();
+        auto end = chrono::high_resolution_clock::now();
+        return chrono::duration<double>(end - start).count();
+    }
+
+    static double timeBackend(const string& name, int n) {
+        mt19937 rng(7);
+        vector<double> A;
+        fillMatrix(A, n, MatrixStructure::Dense, rng);
+        vector<double> b = multiply(A, randomSolution(n, rng), n, n);
+        TuningParams params = { 64, 0, true };
+        auto backend = SolverRegistry<double>::find(name);
+
+        return bestOf(5, [&]() {
+            LinearSystem<double> sys(n);
+            load(sys, A, b);
+            return timed([&]() { backend->run(&sys, params); });
+        });
+    }
+
+    static SparseSystem<double> laplacian(int grid) {
+        EquationGenerator gen;
+        vector<string> lines;
+        for (int i = 0; i < grid * grid; i++) lines.push_back(gen.generateLaplacianEquation(i, grid));
+        SparseSystem<double> sys;
+        sys.addEquations(lines);
+        return sys;
+    }
+
+public:
+    explicit TestSuite(bool verboseOutput = false) : passed(0), failed(0), verbose(verboseOutput) {}
+
+    void runCases() {
+        vector<Case> cases = {
+            { "Standard 2x2 System", 2, { "2x1 + 1x2 = 5", "-1x1 + 1x2 = 2" }, true, true, { 1, 3 } },
+            { "Implicit Coefficients", 2, { "x1 + x2 = 5", "x1 - x2 = 1" }, true, true, { 3, 2 } },
+            { "Unordered Variables", 2, { "4x2 + 3x1 = 10", "x1 - x2 = 1" }, true, true, { 2, 1 } },
+            { "Missing Variables", 2, { "x1 = 5", "2x1 + 3x2 = 16" }, true, true, { 5, 2 } },
+            { "Decimals and Negatives", 2, { "-0.5x1 + 1.5x2 = 3.5", "2.2x1 - 1.1x2 = 0" }, true, true, { 1.4, 2.8 } },
+            { "Scientific Notation", 2, { "2e-1x1 + 1E2x2 = 1.02e+2", "x1 - x2 + 1e-5 = 9.00001" }, true, true, { 10, 1 } },
+            { "Inconsistent System (No Solution)", 2, { "x1 + x2 = 5", "x1 + x2 = 10" }, true, false, {} },
+            { "Dependent System (Infinite Solutions)", 2, { "x1 + x2 = 5", "2x1 + 2x2 = 10" }, true, false, {} },
+            { "Missing Equals Sign", 2, { "3x1 + 4x2 9", "x1 - x2 = 1" }, false, false, {} },
+            { "Multiple Equals Signs", 2, { "3x1 + 4x2 == 9", "x1 - x2 = 1" }, false, false, {} },
+            { "Invalid Characters", 2, { "3x1 + a*x2 = 9", "x1 - x2 = 1" }, false, false, {} },
+        };
+
+        for (size_t k = 0; k < cases.size(); k++) {
+            const Case& c = cases[k];
+            int before = failed;
+            string what = "case " + to_string(k + 1) + " (" + c.desc + ")";
+
+            LinearSystem<double> sys(c.vars);
+            bool parsed = true;
+            for (const string& eq : c.equations) parsed = sys.addEquation(eq) && parsed;
+            check(parsed == c.parses, what + (c.parses ? " rejected valid input" : " accepted invalid input"));
+
+            if (parsed && c.parses) {
+                bool solved = sys.solve();
+                check(solved == c.solvable, what + (c.solvable ? " found no solution" : " solved a singular system"));
+                if (solved && c.solvable) {
+                    for (int i = 0; i < c.vars; i++) {
+                        int col = sys.findVariable("x" + to_string(i + 1));
+                        double got = col >= 0 ? (*sys.getResult())[col] : NAN;
+                        check(fabs(got - c.expected[i]) <= 1e-9 * max(1.0, fabs(c.expected[i])),
+                            what + " x" + to_string(i + 1) + " = " + to_string(got));
+                    }
+                }
+            }
+
+            if (verbose) {
+                cout << "Test " << (k + 1) << ": " << left << setw(40) << c.desc
+                    << (failed == before ? "PASS" : "FAIL") << endl;
+            }
+        }
+    }
+
+    void runSolvers() {
+        vector<int> sizes = { 1, 2, 3, 7, 16, 33, 64, 100, 200 };
+        vector<MatrixStructure> structures = {
+            MatrixStructure::Dense, MatrixStructure::DiagonallyDominant, MatrixStructure::UpperTriangular,
+            MatrixStructure::Symmetric, MatrixStructure::Permutation, MatrixStructure::Tridiagonal };
+
+        unsigned seed = 1;
+        for (int n : sizes) {
+            for (MatrixStructure s : structures) checkBackends(n, s, seed++);
+            checkMultipleRhs(n, seed++);
+            checkLeastSquares(n, seed++);
+            if (n <= 33) checkExact(n, seed++);
+        }
+        checkNaming();
+        checkReducedState();
+        checkTournamentGrowth();
+        checkMultigrid();
+        checkAsync();
+        checkConcurrent();
+        checkVerification();
+    }
+
+    void runParserFuzz(int iterations, unsigned seed) {
+        mt19937 rng(seed);
+        const string alphabet = "0123456789xyzab_XY+-=. ";
+        const string invalid = "*/#(),;:!\t^";
+        const vector<string> names = { "x1", "x2", "x10", "flow_a12", "_t", "Y9", "a", "b_c_d" };
+
+        for (int it = 0; it < iterations; it++) {
+            // Random strings: anything may be rejected, but whatever parses
+            // must survive a round trip through its canonical form.
+            string noise;
+            int len = rng() % 40;
+            for (int i = 0; i < len; i++) noise += alphabet[rng() % alphabet.size()];
+            Equation eq;
+            if (eq.parse(noise) == ParseStatus::Ok) {
+                string text = canonical(eq);
+                Equation again;
+                check(again.parse(text) == ParseStatus::Ok && sameParse(eq, again), "round trip of '" + noise + "' via '" + text + "'");
+            }
+
+            // Generated equations with known per-name totals.
+            map<string, double> expected;
+            double constant = 0;
+            string left, right;
+            int terms = 1 + rng() % 8;
+            for (int t = 0; t < terms; t++) {
+                bool rhs = rng() % 4 == 0;
+                string& side = rhs ? right : left;
+                bool negative = rng() % 2;
+                string sign = negative ? "-" : (side.empty() ? (rng() % 2 ? "+" : "") : "+");
+                double value;
+                string coeff;
+                switch (rng() % 3) {
+                case 0: value = 1; coeff = ""; break;
+                case 1: value = (double)(rng() % 1000); coeff = to_string((int)value); break;
+                default: {
+                    int whole = rng() % 100, frac = rng() % 1000;
+                    coeff = to_string(whole) + "." + to_string(1000 + frac).substr(1);
+                    value = strtod(coeff.c_str(), nullptr);
+                }
+                }
+                if (negative) value = -value;
+
+                if (rng() % 5 == 0) {
+                    if (coeff.empty()) {
+                        coeff = "1";
+                        value = negative ? -1 : 1;
+                    }
+                    side += sign + coeff + (rng() % 2 ? " " : "");
+                    constant += rhs ? value : -value;
+                }
+                else {
+                    const string& name = names[rng() % names.size()];
+                    side += sign + coeff + (rng() % 3 == 0 ? " " : "") + name + (rng() % 2 ? " " : "");
+                    expected[name] += rhs ? -value : value;
+                }
+            }
+            if (right.empty()) {
+                right = "0";
+            }
+            string line = left + (rng() % 2 ? " = " : "=") + right;
+
+            Equation gen;
+            bool ok = gen.parse(line) == ParseStatus::Ok;
+            check(ok, "valid equation rejected: '" + line + "'");
+            if (ok) {
+                map<string, double> got;
+                Vector<Term>& ts = gen.getTerms();
+                for (int i = 0; i < ts.getSize(); i++) got[string(gen.nameOf(ts[i]), ts[i].nameLength)] += ts[i].value;
+                bool match = got.size() == expected.size() && fabs(gen.getConstant() - constant) <= 1e-9 * max(1.0, fabs(constant));
+                for (auto& e : expected) {
+                    match = match && got.count(e.first) && fabs(got[e.first] - e.second) <= 1e-9 * max(1.0, fabs(e.second));
+                }
+                check(match, "wrong terms for '" + line + "'");
+            }
+
+            // Mutations that must be rejected.
+            string bad = line;
+            bad.insert(rng() % (bad.size() + 1), 1, invalid[rng() % invalid.size()]);
+            check(Equation().parse(bad) == ParseStatus::InvalidCharacter, "invalid character accepted: '" + bad + "'");
+
+            string noEquals;
+            for (char c : line) if (c != '=') noEquals += c;
+            check(Equation().parse(noEquals) == ParseStatus::MissingEquals, "missing '=' accepted: '" + noEquals + "'");
+
+            string twoEquals = line;
+            twoEquals.insert(rng() % (twoEquals.size() + 1), 1, '=');
+            check(Equation().parse(twoEquals) == ParseStatus::MultipleEquals, "second '=' accepted: '" + twoEquals + "'");
+        }
+    }
+
+    // Baseline file: "benchmark seconds" lines plus the thread count they
+    // were measured with; a file from another core count is re-recorded.
+    void runPerformance(const string& baselinePath, double thresholdPercent, bool updateBaseline) {
+        vector<pair<string, function<double()>>> benchmarks = {
+            { "parse_4000x100", []() {
+                vector<string> lines;
+                for (int i = 0; i < 4000; i++) {
+                    string s;
+                    for (int j = 0; j < 100; j++) s += "+3flow_a" + to_string((i * 7 + j * 13) % 4000);
+                    lines.push_back(s + "=5");
+                }
+                return bestOf(5, [&]() {
+                    LinearSystem<double> sys(4000, 4000);
+                    return timed([&]() { sys.addEquations(lines); });
+                });
+            } },
+            { "solve_parallel_768", []() { return timeBackend("parallel", 768); } },
+            { "solve_blocked_768", []() { return timeBackend("blocked", 768); } },
+            { "solve_calu_768", []() { return timeBackend("calu", 768); } },
+            { "lstsq_512", []() { return timeBackend("qr", 512); } },
+            { "verify_dense_2048", []() {
+                mt19937 rng(5);
+                vector<double> A;
+                fillMatrix(A, 2048, MatrixStructure::Dense, rng);
+                vector<double> x = randomSolution(2048, rng);
+                vector<double> b = multiply(A, x, 2048, 2048);
+                return bestOf(5, [&]() {
+                    return timed([&]() { SolutionVerifier<double>(x.data(), 2048).addRows(A.data(), b.data(), 2048); });
+                });
+            } },
+            { "amg_setup_512", []() {
+                SparseSystem<double> sys = laplacian(512);
+                sys.assemble();
+                return bestOf(5, [&]() {
+                    AMGSolver<double> amg(AMGCycle::V, AMGSmoother::GaussSeidel);
+                    amg.setup(sys.getMatrix());
+                    return amg.getSetupSeconds();
+                });
+            } },
+            { "amg_pcg_512", []() {
+                SparseSystem<double> sys = laplacian(512);
+                AMGSolver<double> amg(AMGCycle::V, AMGSmoother::GaussSeidel);
+                return bestOf(5, [&]() {
+                    sys.solve(amg);
+                    return amg.getSolveSeconds();
+                });
+            } },
+            { "solve_exact_96", []() {
+                mt19937 rng(11);
+                vector<double> A;
+                fillMatrix(A, 96, MatrixStructure::Dense, rng);
+                vector<double> b = multiply(A, randomSolution(96, rng), 96, 96);
+                LinearSystem<double> sys(96);
+                load(sys, A, b);
+                return bestOf(5, [&]() { return timed([&]() { ModularSolver<double>().solve(&sys); }); });
+            } },
+            { "write_text_500k", []() {
+                vector<double> x(500000);
+                for (size_t i = 0; i < x.size(); i++) x[i] = 1.0 / (double)(i + 3);
+#ifdef _WIN32
+                int fd = _open("NUL", _O_WRONLY);
+#else
+                int fd = ::open("/dev/null", O_WRONLY);
+#endif
+                double t = bestOf(5, [&]() {
+                    return timed([&]() { SolutionWriter<double>::write(fd, x.data(), (int)x.size(), SolutionFormat::Text); });
+                });
+#ifdef _WIN32
+                _close(fd);
+#else
+                ::close(fd);
+#endif
+                return t;
+            } },
+        };
+
+        map<string, double> baseline;
+        int threads = -1;
+        {
+            ifstream in(baselinePath);
+            string line;
+            while (getline(in, line)) {
+                if (line.empty() || line[0] == '#') continue;
+                stringstream ss(line);
+                string key;
+                double value;
+                if (!(ss >> key >> value)) continue;
+                if (key == "threads_available") threads = (int)value;
+                else baseline[key] = value;
+            }
+        }
+        if (threads != availableThreads()) baseline.clear();
+
+        bool recorded = false;
+        cout << left << setw(22) << "benchmark" << setw(14) << "baseline" << setw(14) << "now" << "change" << endl;
+
+        for (auto& b : benchmarks) {
+            double t = b.second();
+            auto found = baseline.find(b.first);
+            cout << left << setw(22) << b.first;
+
+            if (found == baseline.end() || updateBaseline) {
+                cout << setw(14) << "-" << setw(14) << t << "recorded" << endl;
+                baseline[b.first] = t;
+                recorded = true;
+                continue;
+            }
+
+            // A slowdown has to survive two more measurements to count, so
+            // one noisy run on a shared machine doesn't fail the test.
+            for (int retry = 0; retry < 2 && (t / found->second - 1) * 100 > thresholdPercent; retry++) {
+                t = min(t, b.second());
+            }
+
+            double change = (t / found->second - 1) * 100;
+            ostringstream cell;
+            cell << fixed << setprecision(1) << showpos << change << "%";
+            cout << setw(14) << found->second << setw(14) << t << cell.str() << endl;
+            check(change <= thresholdPercent, b.first + " is " + to_string(change) + "% slower than its baseline");
+        }
+
+        if (recorded) {
+            ofstream out(baselinePath);
+            out << "# LinearSolver performance baselines: <benchmark> <seconds>\n";
+            out << "threads_available " << availableThreads() << "\n";
+            for (auto& e : baseline) out << e.first << " " << e.second << "\n";
+            check((bool)out, "could not write " + baselinePath);
+        }
+    }
+
+    int getPassed() const { return passed; }
+    int getFailed() const { return failed; }
+
+    void printSummary() const {
+        cout << passed << " checks passed, " << failed << " failed." << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef TRIANGULARSOLVER_H_
+#define TRIANGULARSOLVER_H_
+
+#include "Matrix.h"
+
+using namespace std;
+
+// Blocked back substitution for U x = b where U is the upper triangle left in
+// a Matrix by forward elimination. Columns are processed in blocks from the
+// bottom up: the small diagonal block is solved serially, then every row above
+// it is updated with one GEMV against the freshly solved block, which is the
+// part that runs in parallel.
+template <typename T>
+class TriangularSolver
+{
+private:
+    int blockSize;
+
+    static const int PARALLEL_WORK_THRESHOLD = 1 << 14;
+
+public:
+    explicit TriangularSolver(int block = 64) : blockSize(block > 0 ? block : 64) {}
+
+    // x holds b on entry and the solution on return.
+    void solveUpper(Matrix<T>& U, T* x, int n) {
+        if (n <= 0) return;
+
+        T** rows = new T * [n];
+        for (int i = 0; i < n; i++) rows[i] = U[i];
+
+        for (int end = n; end > 0; end -= blockSize) {
+            int start = (end - blockSize > 0) ? end - blockSize : 0;
+
+            for (int i = end - 1; i >= start; i--) {
+                const T* row = rows[i];
+                T sum = 0;
+#pragma omp simd reduction(+:sum)
+                for (int j = i + 1; j < end; j++) sum += row[j] * x[j];
+                x[i] = (x[i] - sum) / row[i];
+            }
+
+            int width = end - start;
+#pragma omp parallel for schedule(static) if ((long long)start * width > PARALLEL_WORK_THRESHOLD)
+            for (int r = 0; r < start; r++) {
+                const T* row = rows[r];
+                T sum = 0;
+#pragma omp simd reduction(+:sum)
+                for (int j = start; j < end; j++) sum += row[j] * x[j];
+                x[r] -= sum;
+            }
+        }
+
+        delete[] rows;
+    }
+
+    // X is an n x nrhs row-major block holding B on entry and the solutions
+    // on return, one right-hand side per column.
+    void solveUpperMulti(Matrix<T>& U, T* X, int n, int nrhs) {
+        if (n <= 0 || nrhs <= 0) return;
+        if (nrhs == 1) {
+            solveUpper(U, X, n);
+            return;
+        }
+
+        T** rows = new T * [n];
+        for (int i = 0; i < n; i++) rows[i] = U[i];
+
+        for (int end = n; end > 0; end -= blockSize) {
+            int start = (end - blockSize > 0) ? end - blockSize : 0;
+
+            for (int i = end - 1; i >= start; i--) {
+                const T* row = rows[i];
+                T* xi = X + (size_t)i * nrhs;
+
+                for (int j = i + 1; j < end; j++) {
+                    T a = row[j];
+                    const T* xj = X + (size_t)j * nrhs;
+#pragma omp simd
+                    for (int c = 0; c < nrhs; c++) xi[c] -= a * xj[c];
+                }
+
+                T inv = T(1) / row[i];
+#pragma omp simd
+                for (int c = 0; c < nrhs; c++) xi[c] *= inv;
+            }
+
+            int width = end - start;
+#pragma omp parallel for schedule(static) if ((long long)start * width * nrhs > PARALLEL_WORK_THRESHOLD)
+            for (int r = 0; r < start; r++) {
+                const T* row = rows[r];
+                T* xr = X + (size_t)r * nrhs;
+
+                for (int j = start; j < end; j++) {
+                    T a = row[j];
+                    const T* xj = X + (size_t)j * nrhs;
+#pragma omp simd
+                    for (int c = 0; c < nrhs; c++) xr[c] -= a * xj[c];
+                }
+            }
+        }
+
+        delete[] rows;
+    }
+};
+
+#endif
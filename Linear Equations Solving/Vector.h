@@ -64,19 +64,15 @@ public:
         }
         return *this;
     }
+    // Bounds are checked in debug builds only; a library caller's process
+    // is never terminated from here.
     T& operator[](int index) {
-        if (index < 0 || index >= size) {
-            cerr << "Vector index out of bounds! Index: " << index << ", Size: " << size << endl;
-            exit(1);
-        }
+        assert(index >= 0 && index < size && "Vector index out of bounds");
         return data[index];
     }
 
     const T& operator[](int index) const {
-        if (index < 0 || index >= size) {
-            cerr << "Vector index out of bounds!" << endl;
-            exit(1);
-        }
+        assert(index >= 0 && index < size && "Vector index out of bounds");
         return data[index];
     }
 